@@ -828,13 +828,7 @@ void ComputeFFTGrid::irregular_create()
 
   if (!grid->hashfilled) grid->rehash();
 
-#ifdef SPARTA_MAP
-  std::map<cellint,int> *hash = grid->hash;
-#elif defined SPARTA_UNORDERED_MAP
-  std::unordered_map<cellint,int> *hash = grid->hash;
-#else
-  std::tr1::unordered_map<cellint,int> *hash = grid->hash;
-#endif
+  Grid::MyHash *hash = grid->hash;
 
   idrecv = (cellint *) rbuf2;
 
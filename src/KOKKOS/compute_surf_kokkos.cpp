@@ -42,7 +42,8 @@ ComputeSurfKokkos::ComputeSurfKokkos(SPARTA *sparta, int narg, char **arg) :
 ComputeSurfKokkos::ComputeSurfKokkos(SPARTA *sparta) :
   ComputeSurf(sparta)
 {
-  hash = NULL;
+  surf2tally = NULL;
+  tally2index = NULL;
   which = NULL;
   array_surf_tally = NULL;
   tally2surf = NULL;
@@ -71,6 +71,7 @@ GridKokkos::~GridKokkos()
   cinfo = NULL;
   sinfo = NULL;
   pcells = NULL;
+  pbox = NULL;
 }
 
 ///////////////////////////////////////////////////////////////////////////
@@ -125,14 +126,17 @@ void GridKokkos::grow_pcells(int n)
 
     if (nparent+n >= maxparent) {
       while (maxparent < nparent+n) maxparent += DELTA;
-      if (pcells == NULL)
+      if (pcells == NULL) {
           k_pcells = tdual_pcell_1d("grid:pcells",maxparent);
-      else {
+          k_pbox = tdual_pbox_1d("grid:pbox",maxparent);
+      } else {
         this->sync(Device,PCELL_MASK); // force resize on device
         k_pcells.resize(maxparent);
+        k_pbox.resize(maxparent);
         this->modify(Device,PCELL_MASK); // needed for auto sync
       }
       pcells = k_pcells.h_view.data();
+      pbox = k_pbox.h_view.data();
     }
   }
 }
@@ -277,6 +281,16 @@ void GridKokkos::wrap_kokkos()
     memory->sfree(pcells);
     pcells = k_pcells.h_view.data();
   }
+
+  // pbox
+
+  if (pbox != k_pbox.h_view.data()) {
+    memoryKK->wrap_kokkos(k_pbox,pbox,maxparent,"grid:pbox");
+    k_pbox.modify<SPAHostType>();
+    k_pbox.sync<DeviceType>();
+    memory->sfree(pbox);
+    pbox = k_pbox.h_view.data();
+  }
 }
 
 /* ---------------------------------------------------------------------- */
@@ -296,11 +310,13 @@ void GridKokkos::sync(ExecutionSpace space, unsigned int mask)
     if (mask & CELL_MASK) k_cells.sync<SPADeviceType>();
     if (mask & CINFO_MASK) k_cinfo.sync<SPADeviceType>();
     if (mask & PCELL_MASK) k_pcells.sync<SPADeviceType>();
+    if (mask & PCELL_MASK) k_pbox.sync<SPADeviceType>();
     if (mask & SINFO_MASK) k_sinfo.sync<SPADeviceType>();
   } else {
     if (mask & CELL_MASK) k_cells.sync<SPAHostType>();
     if (mask & CINFO_MASK) k_cinfo.sync<SPAHostType>();
     if (mask & PCELL_MASK) k_pcells.sync<SPAHostType>();
+    if (mask & PCELL_MASK) k_pbox.sync<SPAHostType>();
     if (mask & SINFO_MASK) k_sinfo.sync<SPAHostType>();
   }
 }
@@ -320,6 +336,7 @@ void GridKokkos::modify(ExecutionSpace space, unsigned int mask)
     if (mask & CELL_MASK) k_cells.modify<SPADeviceType>();
     if (mask & CINFO_MASK) k_cinfo.modify<SPADeviceType>();
     if (mask & PCELL_MASK) k_pcells.modify<SPADeviceType>();
+    if (mask & PCELL_MASK) k_pbox.modify<SPADeviceType>();
     if (mask & SINFO_MASK) k_sinfo.modify<SPADeviceType>();
     if (sparta->kokkos->auto_sync)
       sync(Host,mask);
@@ -327,6 +344,7 @@ void GridKokkos::modify(ExecutionSpace space, unsigned int mask)
     if (mask & CELL_MASK) k_cells.modify<SPAHostType>();
     if (mask & CINFO_MASK) k_cinfo.modify<SPAHostType>();
     if (mask & PCELL_MASK) k_pcells.modify<SPAHostType>();
+    if (mask & PCELL_MASK) k_pbox.modify<SPAHostType>();
     if (mask & SINFO_MASK) k_sinfo.modify<SPAHostType>();
   }
 }
@@ -56,8 +56,8 @@ class GridKokkos : public Grid {
     typedef hash_type::value_type value_type;  // int
 
     ParentCell *p = &k_pcells.d_view[iparent];
-    double *lo = p->lo;
-    double *hi = p->hi;
+    double *lo = k_pbox.d_view[iparent].lo;
+    double *hi = k_pbox.d_view[iparent].hi;
     int nx = p->nx;
     int ny = p->ny;
     int nz = p->nz;
@@ -102,6 +102,7 @@ class GridKokkos : public Grid {
   tdual_cinfo_1d k_cinfo;
   tdual_sinfo_1d k_sinfo;
   tdual_pcell_1d k_pcells;
+  tdual_pbox_1d k_pbox;
 
   Kokkos::Crs<int, SPADeviceType, void, int> d_csurfs;
   Kokkos::Crs<int, SPADeviceType, void, int> d_csplits;
@@ -300,32 +300,9 @@ int IrregularKokkos::augment_data_uniform(int n, int *proclist)
     }
   }
 
-  // tell receivers how many datums I send them
-  // sendmax = largest # of datums I send in a single message
+  // exchange datum counts with procs of plan via persistent requests
 
-  sendmax = 0;
-  for (i = 0; i < nsend; i++) {
-    MPI_Send(&num_send[i],1,MPI_INT,proc_send[i],0,world);
-    sendmax = MAX(sendmax,num_send[i]);
-  }
-
-  // receive incoming messages
-  // num_recv = # of datums each proc sends me
-  // nrecvdatum = total # of datums I recv
-
-  nrecvdatum = 0;
-  for (i = 0; i < nrecv; i++) {
-    MPI_Recv(&m,1,MPI_INT,MPI_ANY_SOURCE,0,world,status);
-    iproc = status->MPI_SOURCE;
-    num_recv[proc2recv[iproc]] = m;
-    nrecvdatum += m;
-  }
-  nrecvdatum += num_self;
-
-  // barrier to insure all MPI_ANY_SOURCE messages are received
-  // else another proc could proceed to exchange_data() and send to me
-
-  MPI_Barrier(world);
+  augment_counts();
 
   // return # of datums I will receive
 
@@ -406,6 +406,11 @@ namespace SPARTA_NS {
   typedef tdual_pcell_1d::t_dev t_pcell_1d;
   typedef tdual_pcell_1d::t_host t_host_pcell_1d;
 
+  typedef Kokkos::
+    DualView<Grid::ParentBox*, SPADeviceType::array_layout, DeviceType> tdual_pbox_1d;
+  typedef tdual_pbox_1d::t_dev t_pbox_1d;
+  typedef tdual_pbox_1d::t_host t_host_pbox_1d;
+
   typedef Kokkos::
     DualView<Surf::Line*, SPADeviceType::array_layout, DeviceType> tdual_line_1d;
   typedef tdual_line_1d::t_dev t_line_1d;
@@ -236,6 +236,56 @@ int MPI_Irecv(void *buf, int count, MPI_Datatype datatype,
 
 /* ---------------------------------------------------------------------- */
 
+int MPI_Send_init(const void *buf, int count, MPI_Datatype datatype,
+                  int dest, int tag, MPI_Comm comm, MPI_Request *request)
+{
+  printf("MPI Stub WARNING: Should not send message to self\n");
+  return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int MPI_Recv_init(void *buf, int count, MPI_Datatype datatype,
+                  int source, int tag, MPI_Comm comm, MPI_Request *request)
+{
+  printf("MPI Stub WARNING: Should not recv message from self\n");
+  return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int MPI_Startall(int n, MPI_Request *request)
+{
+  printf("MPI Stub WARNING: Should not start message to self\n");
+  return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int MPI_Request_free(MPI_Request *request)
+{
+  return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int MPI_Probe(int source, int tag, MPI_Comm comm, MPI_Status *status)
+{
+  printf("MPI Stub WARNING: Should not probe message from self\n");
+  return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int MPI_Iprobe(int source, int tag, MPI_Comm comm, int *flag,
+               MPI_Status *status)
+{
+  *flag = 0;
+  return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
 int MPI_Wait(MPI_Request *request, MPI_Status *status)
 {
   printf("MPI Stub WARNING: Should not wait on message from self\n");
@@ -288,6 +338,15 @@ int MPI_Comm_split(MPI_Comm comm, int color, int key, MPI_Comm *comm_out)
 
 /* ---------------------------------------------------------------------- */
 
+int MPI_Comm_split_type(MPI_Comm comm, int split_type, int key,
+                        MPI_Info info, MPI_Comm *comm_out)
+{
+  *comm_out = comm;
+  return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
 int MPI_Comm_dup(MPI_Comm comm, MPI_Comm *comm_out)
 {
   *comm_out = comm;
@@ -334,6 +393,51 @@ int MPI_Group_incl(MPI_Group group, int n, int *ranks, MPI_Group *newgroup)
 }
 /* ---------------------------------------------------------------------- */
 
+/* single window of one proc, memory is held in stub_win_ptr */
+
+static void *stub_win_ptr = NULL;
+static MPI_Aint stub_win_size = 0;
+
+int MPI_Win_allocate_shared(MPI_Aint size, int disp_unit, MPI_Info info,
+                            MPI_Comm comm, void *baseptr, MPI_Win *win)
+{
+  free(stub_win_ptr);
+  stub_win_ptr = malloc(size > 0 ? size : 1);
+  stub_win_size = size;
+  *((void **) baseptr) = stub_win_ptr;
+  *win = 0;
+  return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int MPI_Win_shared_query(MPI_Win win, int rank, MPI_Aint *size,
+                         int *disp_unit, void *baseptr)
+{
+  *size = stub_win_size;
+  *disp_unit = 1;
+  *((void **) baseptr) = stub_win_ptr;
+  return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int MPI_Win_lock_all(int assert, MPI_Win win) {return 0;}
+int MPI_Win_unlock_all(MPI_Win win) {return 0;}
+int MPI_Win_sync(MPI_Win win) {return 0;}
+
+/* ---------------------------------------------------------------------- */
+
+int MPI_Win_free(MPI_Win *win)
+{
+  free(stub_win_ptr);
+  stub_win_ptr = NULL;
+  stub_win_size = 0;
+  return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
 int MPI_Cart_create(MPI_Comm comm_old, int ndims, int *dims, int *periods,
                     int reorder, MPI_Comm *comm_cart)
 {
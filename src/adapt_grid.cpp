@@ -196,12 +196,12 @@ void AdaptGrid::command(int narg, char **arg)
            "hi %g %g %g\n",
            comm->me,i,p->id,str,p->iparent,p->level,
            p->nx,p->ny,p->nz,
-           p->lo[0],
-           p->lo[1],
-           p->lo[2],
-           p->hi[0],
-           p->hi[1],
-           p->hi[2]);
+           grid->pbox[i].lo[0],
+           grid->pbox[i].lo[1],
+           grid->pbox[i].lo[2],
+           grid->pbox[i].hi[0],
+           grid->pbox[i].hi[1],
+           grid->pbox[i].hi[2]);
   }
 
   printf("POST ADAPT %d: %d\n",comm->me,grid->nlocal);
@@ -1037,6 +1037,7 @@ void AdaptGrid::gather_parents_refine(int delta, int nrefine)
   MPI_Allgatherv(pcells_mine,nsend,MPI_CHAR,
                  &pcells[nprev],recvcounts,displs,MPI_CHAR,world);
   grid->nparent = nprev + nrefine;
+  grid->parent_box(nprev);
   
   // loop over all added pcells
   // repoint any child cells I own to new parent
@@ -1128,10 +1129,15 @@ void AdaptGrid::assign_parents_coarsen(int pstop)
   memory->create(powner,pstop,"adapt_grid:powner");
   for (i = 0; i < pstop; i++) powner[i] = -1;
 
+  double lo[3],hi[3];
+
   for (i = 0; i < pstop; i++) {
     if (pcells[i].grandparent) continue;
     if (pcells[i].level < minlevel) continue;
-    if (region && !region_check(pcells[i].lo,pcells[i].hi)) continue;
+    if (region) {
+      grid->parent_lohi(i,lo,hi);
+      if (!region_check(lo,hi)) continue;
+    }
 
     nxyz = pcells[i].nx * pcells[i].ny * pcells[i].nz;
     if (pcount[i] == nxyz) powner[i] = me;
@@ -1611,7 +1617,8 @@ void AdaptGrid::coarsen_surf()
   int i,j,m,iparent,nchild,icell,nsurf,flag;
   int *proc,*index,*recv;
   surfint *csurfs;
-  double *lo,*hi,*norm;
+  double *norm;
+  double lo[3],hi[3];
 
   int dim = domain->dimension;
   Grid::ParentCell *pcells = grid->pcells;
@@ -1629,8 +1636,7 @@ void AdaptGrid::coarsen_surf()
     index = ctask[i].index;
     recv = ctask[i].recv;
 
-    lo = pcells[iparent].lo;
-    hi = pcells[iparent].hi;
+    grid->parent_lohi(iparent,lo,hi);
     flag = 0;
     if (fabs(hi[0]-lo[0])/pcells[iparent].nx < surfsize) flag = 1;
     if (fabs(hi[1]-lo[1])/pcells[iparent].ny < surfsize) flag = 1;
@@ -1997,6 +2003,7 @@ void AdaptGrid::gather_parents_coarsen(int delta, int nrefine)
   // remove parent cell from hash
 
   Grid::ParentCell *pcells = grid->pcells;
+  Grid::ParentBox *pbox = grid->pbox;
   Grid::MyHash *hash = grid->hash;
 
   for (i = 0; i < deltaall; i++) {
@@ -2015,7 +2022,10 @@ void AdaptGrid::gather_parents_coarsen(int delta, int nrefine)
   int nparent = 1;
   for (i = 1; i < ncurrent; i++) {
     if (pcells[i].id) {
-      if (i > nparent) memcpy(&pcells[nparent],&pcells[i],psize);
+      if (i > nparent) {
+        memcpy(&pcells[nparent],&pcells[i],psize);
+        if (pbox) pbox[nparent] = pbox[i];
+      }
       (*hash)[pcells[i].id] = -(nparent+1);
       nparent++;
     }
@@ -2046,12 +2056,12 @@ void AdaptGrid::gather_parents_coarsen(int delta, int nrefine)
            "hi %g %g %g\n",
            comm->me,i,p->id,str,p->iparent,p->grandparent,p->level,
            p->nx,p->ny,p->nz,
-           p->lo[0],
-           p->lo[1],
-           p->lo[2],
-           p->hi[0],
-           p->hi[1],
-           p->hi[2]);
+           grid->pbox[i].lo[0],
+           grid->pbox[i].lo[1],
+           grid->pbox[i].lo[2],
+           grid->pbox[i].hi[0],
+           grid->pbox[i].hi[1],
+           grid->pbox[i].hi[2]);
   }
 
 
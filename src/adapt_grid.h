@@ -121,7 +121,7 @@ class AdaptGrid : protected Pointers {
 #elif SPARTA_UNORDERED_MAP
   typedef std::unordered_map<cellint,int> MyHash;
 #else
-  typedef std::tr1::unordered_map<cellint,int> MyHash;
+  typedef FlatHash<cellint> MyHash;
 #endif
 
   MyHash *chash;
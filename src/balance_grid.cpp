@@ -22,6 +22,7 @@
 #include "modify.h"
 #include "comm.h"
 #include "rcb.h"
+#include "sfc.h"
 #include "output.h"
 #include "dump.h"
 #include "random_mars.h"
@@ -34,7 +35,7 @@ using namespace SPARTA_NS;
 
 //#define RCB_DEBUG 1     // un-comment to include RCB proc boxes in image
 
-enum{NONE,STRIDE,CLUMP,BLOCK,RANDOM,PROC,BISECTION};
+enum{NONE,STRIDE,CLUMP,BLOCK,RANDOM,PROC,BISECTION,CURVE};
 enum{XYZ,XZY,YXZ,YZX,ZXY,ZYX};
 enum{CELL,PARTICLE,TIME};
 
@@ -117,7 +118,16 @@ void BalanceGrid::command(int narg, char **arg, int outflag)
     else if (strcmp(arg[1],"time") == 0) rcbwt = TIME;
     else error->all(FLERR,"Illegal balance_grid command");
     iarg = 2;
-  }
+
+  } else if (strcmp(arg[0],"sfc") == 0) {
+    if (narg < 2) error->all(FLERR,"Illegal balance_grid command");
+    bstyle = CURVE;
+    if (strcmp(arg[1],"cell") == 0) rcbwt = CELL;
+    else if (strcmp(arg[1],"part") == 0) rcbwt = PARTICLE;
+    else if (strcmp(arg[1],"time") == 0) rcbwt = TIME;
+    else error->all(FLERR,"Illegal balance_grid command");
+    iarg = 2;
+  } else error->all(FLERR,"Illegal balance_grid command");
 
   // optional args
 
@@ -288,9 +298,7 @@ void BalanceGrid::command(int narg, char **arg, int outflag)
 
     delete random;
 
-  } else if (bstyle == BISECTION) {
-    RCB *rcb = new RCB(sparta);
-
+  } else if (bstyle == BISECTION || bstyle == CURVE) {
     double **x;
     memory->create(x,nglocal,3,"balance_grid:x");
 
@@ -328,32 +336,48 @@ void BalanceGrid::command(int narg, char **arg, int outflag)
       timer_cell_weights(wt);
     }
 
-    rcb->compute(nbalance,x,wt,eligible,rcbflip);
+    if (bstyle == BISECTION) {
+      RCB *rcb = new RCB(sparta);
+      rcb->compute(nbalance,x,wt,eligible,rcbflip);
 
-    // DEBUG info for dump image
+      // DEBUG info for dump image
 
 #ifdef RCB_DEBUG
 
-    update->rcblo[0] = rcb->lo[0];
-    update->rcblo[1] = rcb->lo[1];
-    update->rcblo[2] = rcb->lo[2];
-    update->rcbhi[0] = rcb->hi[0];
-    update->rcbhi[1] = rcb->hi[1];
-    update->rcbhi[2] = rcb->hi[2];
+      update->rcblo[0] = rcb->lo[0];
+      update->rcblo[1] = rcb->lo[1];
+      update->rcblo[2] = rcb->lo[2];
+      update->rcbhi[0] = rcb->hi[0];
+      update->rcbhi[1] = rcb->hi[1];
+      update->rcbhi[2] = rcb->hi[2];
 
 #endif 
 
-    rcb->invert();
+      rcb->invert();
 
-    nbalance = 0;
-    int *sendproc = rcb->sendproc;
-    for (int icell = 0; icell < nglocal; icell++) {
-      if (cells[icell].nsplit <= 0) continue;
-      cells[icell].proc = sendproc[nbalance++];
+      nbalance = 0;
+      int *sendproc = rcb->sendproc;
+      for (int icell = 0; icell < nglocal; icell++) {
+        if (cells[icell].nsplit <= 0) continue;
+        cells[icell].proc = sendproc[nbalance++];
+      }
+      nmigrate = nbalance - rcb->nkeep;
+      delete rcb;
+
+    } else {
+      SFC *sfc = new SFC(sparta);
+      sfc->compute(nbalance,x,wt);
+
+      nbalance = 0;
+      int *sendproc = sfc->sendproc;
+      for (int icell = 0; icell < nglocal; icell++) {
+        if (cells[icell].nsplit <= 0) continue;
+        cells[icell].proc = sendproc[nbalance++];
+      }
+      nmigrate = nbalance - sfc->nkeep;
+      delete sfc;
     }
-    nmigrate = nbalance - rcb->nkeep;
 
-    delete rcb;
     memory->destroy(x);
     memory->destroy(wt);
   }
@@ -361,7 +385,8 @@ void BalanceGrid::command(int narg, char **arg, int outflag)
   // set clumped or not, depending on style
   // NONE style does not change clumping
 
-  if (nprocs == 1 || bstyle == CLUMP || bstyle == BLOCK || bstyle == BISECTION) 
+  if (nprocs == 1 || bstyle == CLUMP || bstyle == BLOCK || 
+      bstyle == BISECTION || bstyle == CURVE) 
     grid->clumped = 1;
   else if (bstyle != NONE) grid->clumped = 0;
 
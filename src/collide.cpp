@@ -29,6 +29,10 @@
 #include "memory.h"
 #include "error.h"
 
+#if defined(_OPENMP)
+#include "omp.h"
+#endif
+
 using namespace SPARTA_NS;
 
 enum{NONE,DISCRETE,SMOOTH};       // several files  (NOTE: change order)
@@ -55,6 +59,7 @@ Collide::Collide(SPARTA *sparta, int, char **arg) : Pointers(sparta)
   random = new RanPark(update->ranmaster->uniform());
   double seed = update->ranmaster->uniform();
   random->reset(seed,comm->me,100);
+  cseed = -1.0;
 
   ngroups = 0;
 
@@ -71,6 +76,12 @@ Collide::Collide(SPARTA *sparta, int, char **arg) : Pointers(sparta)
   maxdelete = 0;
   dellist = NULL;
 
+  treact = NULL;
+  rseed = -1.0;
+  deferflag = 0;
+  ncreate = maxcreate = 0;
+  createlist = NULL;
+
   vre_first = 1;
   vre_start = 1;
   vre_every = 0;
@@ -82,6 +93,7 @@ Collide::Collide(SPARTA *sparta, int, char **arg) : Pointers(sparta)
   vibstyle = NONE;
   nearcp = 0;
   nearlimit = 10;
+  batchflag = 0;
 
   recomb_ijflag = NULL;
 
@@ -89,6 +101,16 @@ Collide::Collide(SPARTA *sparta, int, char **arg) : Pointers(sparta)
   maxelectron = 0;
   elist = NULL;
 
+  // used if batched attempts are enabled
+
+  batchable = 0;
+  batch = 0;
+  maxbatch = maxmark = 0;
+  bi = bj = NULL;
+  bip = bjp = NULL;
+  brn = bvr2 = bvre = NULL;
+  bmark = NULL;
+
   // used if near-neighbor model is invoked
 
   max_nn = 1;
@@ -101,6 +123,9 @@ Collide::Collide(SPARTA *sparta, int, char **arg) : Pointers(sparta)
   ncollide_one = nattempt_one = nreact_one = 0;
   ncollide_running = nattempt_running = nreact_running = 0;
 
+  nthreads = 1;
+  tcollide = NULL;
+
   copymode = kokkos_flag = 0;
 }
 
@@ -110,6 +135,8 @@ Collide::~Collide()
 { 
   if (copymode) return;
 
+  destroy_threads();
+
   delete [] style;
   delete [] mixID;
   delete random;
@@ -124,6 +151,7 @@ Collide::~Collide()
   }
 
   memory->destroy(dellist);
+  memory->sfree(createlist);
   memory->sfree(elist);
   memory->destroy(vremax);
   memory->destroy(vremax_initial);
@@ -131,6 +159,7 @@ Collide::~Collide()
   memory->destroy(nn_last_partner);
   memory->destroy(nn_last_partner_igroup);
   memory->destroy(nn_last_partner_jgroup);
+  destroy_batch();
 
   memory->destroy(recomb_ijflag);
 }
@@ -139,6 +168,11 @@ Collide::~Collide()
 
 void Collide::init()
 {
+  // per-thread copies are re-created on first collisions() of the run
+  // must be done before ngroups is reset
+
+  destroy_threads();
+
   // error check
 
   if (ambiflag && nearcp) 
@@ -314,6 +348,44 @@ void Collide::init()
     vre_first = 0;
   }
 
+  // threads are only used if cells can be processed independently
+  // ambipolar approximation uses shared electron list
+  // reactions use a per-thread copy of React class, see create_threads()
+
+  treact = react;
+  nthreads = 1;
+#if defined(_OPENMP)
+  if (!ambiflag) nthreads = omp_get_max_threads();
+#endif
+
+  // batches assume particle lists do not change within a cell
+  //   and partners are chosen independently of each other
+
+  batch = 0;
+  if (batchflag) {
+    if (!batchable) {
+      if (comm->me == 0)
+        error->warning(FLERR,
+                       "Collision style does not support collide_modify batch");
+    } else if (react || ambiflag || nearcp) {
+      if (comm->me == 0)
+        error->warning(FLERR,"Collide_modify batch is ignored with "
+                       "reactions, ambipolar, or nearcp");
+    } else batch = 1;
+  }
+
+  // counter-based RNG streams are keyed by a seed from the master RNG,
+  //   which is the same on all procs, and re-selected for each cell
+  // React RNG is drawn from inside cells as well, so gets its own key
+
+  cseed = rseed = -1.0;
+  if (update->rng_counter) cseed = update->ranmaster->uniform();
+  random->counter(cseed);
+  if (react) {
+    if (update->rng_counter) rseed = update->ranmaster->uniform();
+    react->get_random()->counter(rseed);
+  }
+
   // initialize running stats before each run
 
   ncollide_running = nattempt_running = nreact_running = 0;
@@ -371,6 +443,12 @@ void Collide::modify_params(int narg, char **arg)
       if (nearcp && nearlimit <= 0) 
         error->all(FLERR,"Illegal collide_modify command");
       iarg += 3;
+    } else if (strcmp(arg[iarg],"batch") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal collide_modify command");
+      if (strcmp(arg[iarg+1],"yes") == 0) batchflag = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) batchflag = 0;
+      else error->all(FLERR,"Illegal collide_modify command");
+      iarg += 2;
 
     } else error->all(FLERR,"Illegal collide_modify command");
   }
@@ -412,7 +490,10 @@ void Collide::collisions()
   // perform collisions without or with ambipolar approximation
   // one variant is optimized for a single group
 
-  if (!ambiflag) {
+  if (nthreads > 1) collisions_threaded();
+  else if (!ambiflag) {
+    cfirst = 0;
+    clast = nglocal;
     if (nearcp == 0) {
       if (ngroups == 1) collisions_one<0>();
       else collisions_group<0>();
@@ -439,6 +520,229 @@ void Collide::collisions()
   nreact_running += nreact_one;
 }
 
+/* ----------------------------------------------------------------------
+   perform collisions with OpenMP threads
+   each thread loops over a contiguous chunk of owned cells
+   via its own copy of this class, so RNG and scratch lists are not shared
+   per-cell vremax,remain are shared, but each cell is touched by one thread
+   particles created or deleted by reactions are stored in per-thread lists
+     and added to or removed from Particle class after all threads finish,
+     so particle array is not reallocated while threads use it
+------------------------------------------------------------------------- */
+
+void Collide::collisions_threaded()
+{
+  if (!tcollide) create_threads();
+
+  // per-cell arrays may have been reallocated since last step
+
+  for (int ithread = 0; ithread < nthreads; ithread++) {
+    Collide *c = tcollide[ithread];
+    c->nglocal = nglocal;
+    c->vremax = vremax;
+    c->remain = remain;
+    c->cfirst = static_cast<bigint> (nglocal) * ithread / nthreads;
+    c->clast = static_cast<bigint> (nglocal) * (ithread+1) / nthreads;
+    c->ncollide_one = c->nattempt_one = c->nreact_one = 0;
+    c->ndelete = c->ncreate = 0;
+    c->deferflag = 1;
+  }
+
+#if defined(_OPENMP)
+#pragma omp parallel num_threads(nthreads)
+#endif
+  {
+    int ithread = 0;
+#if defined(_OPENMP)
+    ithread = omp_get_thread_num();
+#endif
+    Collide *c = tcollide[ithread];
+
+    if (nearcp == 0) {
+      if (ngroups == 1) c->collisions_one<0>();
+      else c->collisions_group<0>();
+    } else {
+      if (ngroups == 1) c->collisions_one<1>();
+      else c->collisions_group<1>();
+    }
+  }
+
+  deferflag = 0;
+
+  for (int ithread = 1; ithread < nthreads; ithread++) {
+    Collide *c = tcollide[ithread];
+    ncollide_one += c->ncollide_one;
+    nattempt_one += c->nattempt_one;
+    nreact_one += c->nreact_one;
+  }
+
+  if (!react) return;
+
+  // merge per-thread deletion lists into this class's list
+  // indices are all < nlocal since no particles were added during threading
+
+  for (int ithread = 1; ithread < nthreads; ithread++) {
+    Collide *c = tcollide[ithread];
+    if (ndelete + c->ndelete > maxdelete) {
+      maxdelete = ndelete + c->ndelete + DELTADELETE;
+      memory->grow(dellist,maxdelete,"collide:dellist");
+    }
+    for (int i = 0; i < c->ndelete; i++) dellist[ndelete++] = c->dellist[i];
+  }
+
+  // add created particles in thread order, so in order of owning cells
+  // merge per-thread reaction tallies
+
+  for (int ithread = 0; ithread < nthreads; ithread++) {
+    Collide *c = tcollide[ithread];
+    Particle::OnePart *p = c->createlist;
+    for (int i = 0; i < c->ncreate; i++)
+      particle->add_particle(p[i].id,p[i].ispecies,p[i].icell,
+                             p[i].x,p[i].v,p[i].erot,p[i].evib);
+    if (ithread) react->merge_thread(c->treact);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   create one copy of this class per thread, thread 0 uses this class
+   each copy gets its own RNG, seeded from this class's RNG,
+   its own one-cell scratch lists and create/delete lists,
+   and its own copy of React class with its own RNG and tallies
+------------------------------------------------------------------------- */
+
+void Collide::create_threads()
+{
+  tcollide = new Collide*[nthreads];
+  tcollide[0] = this;
+
+  for (int ithread = 1; ithread < nthreads; ithread++) {
+    Collide *c = copy_thread();
+    if (!c) error->all(FLERR,"Collision style does not support OpenMP threads");
+    tcollide[ithread] = c;
+
+    double seed = random->uniform();
+    c->random = new RanPark(seed);
+    c->random->reset(seed,ithread,100);
+    c->random->counter(cseed);
+
+    if (react) {
+      c->treact = react->copy_thread(ithread);
+      if (!c->treact) 
+        error->all(FLERR,"Reaction style does not support OpenMP threads");
+      c->treact->get_random()->counter(rseed);
+    }
+
+    c->ndelete = c->maxdelete = 0;
+    c->dellist = NULL;
+    c->ncreate = c->maxcreate = 0;
+    c->createlist = NULL;
+
+    c->maxbatch = c->maxmark = 0;
+    c->bi = c->bj = NULL;
+    c->bip = c->bjp = NULL;
+    c->brn = c->bvr2 = c->bvre = NULL;
+    c->bmark = NULL;
+
+    c->npmax = 0;
+    c->plist = NULL;
+    if (ngroups == 1) {
+      c->npmax = DELTAPART;
+      memory->create(c->plist,c->npmax,"collide:plist");
+    } else {
+      c->ngroup = new int[ngroups];
+      c->maxgroup = new int[ngroups];
+      c->glist = new int*[ngroups];
+      for (int i = 0; i < ngroups; i++) {
+        c->maxgroup[i] = DELTAPART;
+        memory->create(c->glist[i],DELTAPART,"collide:glist");
+      }
+      memory->create(c->gpair,ngroups*ngroups,3,"collide:gpair");
+    }
+
+    c->max_nn = 1;
+    memory->create(c->nn_last_partner,c->max_nn,"collide:nn_last_partner");
+    memory->create(c->nn_last_partner_igroup,c->max_nn,
+                   "collide:nn_last_partner");
+    memory->create(c->nn_last_partner_jgroup,c->max_nn,
+                   "collide:nn_last_partner");
+  }
+}
+
+/* ----------------------------------------------------------------------
+   free per-thread copies of this class and what they allocated
+------------------------------------------------------------------------- */
+
+void Collide::destroy_threads()
+{
+  if (!tcollide) return;
+
+  for (int ithread = 1; ithread < nthreads; ithread++) {
+    Collide *c = tcollide[ithread];
+    delete c->random;
+    if (c->treact != react) delete c->treact;
+    memory->destroy(c->dellist);
+    memory->sfree(c->createlist);
+    memory->destroy(c->plist);
+    if (ngroups > 1) {
+      delete [] c->ngroup;
+      delete [] c->maxgroup;
+      for (int i = 0; i < ngroups; i++) memory->destroy(c->glist[i]);
+      delete [] c->glist;
+      memory->destroy(c->gpair);
+    }
+    memory->destroy(c->nn_last_partner);
+    memory->destroy(c->nn_last_partner_igroup);
+    memory->destroy(c->nn_last_partner_jgroup);
+    c->destroy_batch();
+    delete c;
+  }
+
+  delete [] tcollide;
+  tcollide = NULL;
+}
+
+/* ----------------------------------------------------------------------
+   store a particle created by a reaction in this thread's create list
+   it is added to Particle class by collisions_threaded()
+   return ptr to stored particle, valid until next call
+------------------------------------------------------------------------- */
+
+Particle::OnePart *Collide::defer_particle(int id, int ispecies, int icell,
+                                           double *x, double *v)
+{
+  if (ncreate == maxcreate) {
+    maxcreate += DELTADELETE;
+    createlist = (Particle::OnePart *) 
+      memory->srealloc(createlist,maxcreate*sizeof(Particle::OnePart),
+                       "collide:createlist");
+  }
+
+  Particle::OnePart *p = &createlist[ncreate++];
+  memset(p,0,sizeof(Particle::OnePart));
+  p->id = id;
+  p->ispecies = ispecies;
+  p->icell = icell;
+  memcpy(p->x,x,3*sizeof(double));
+  memcpy(p->v,v,3*sizeof(double));
+  return p;
+}
+
+/* ----------------------------------------------------------------------
+   select counter-based RNG streams for collisions in cell icell
+   keyed by timestep, cell ID, and sub cell index
+   so RNs do not depend on which proc or thread owns the cell
+------------------------------------------------------------------------- */
+
+void Collide::cell_stream(int icell)
+{
+  Grid::ChildCell *cells = grid->cells;
+  bigint step = update->ntimestep;
+  int isub = 1 - cells[icell].nsplit;
+
+  random->stream(step,cells[icell].id,isub);
+  if (react) treact->get_random()->stream(step,cells[icell].id,isub);
+}
+
 /* ----------------------------------------------------------------------
    NTC algorithm for a single group
 ------------------------------------------------------------------------- */
@@ -450,16 +754,18 @@ template < int NEARCP > void Collide::collisions_one()
   double attempt,volume;
   Particle::OnePart *ipart,*jpart,*kpart;
 
-  // loop over cells I own
+  // loop over cells I own, from cfirst to clast-1
 
   Grid::ChildInfo *cinfo = grid->cinfo;
 
   Particle::OnePart *particles = particle->particles;
   int *next = particle->next;
+  int contiguous = particle->contiguous;
 
-  for (int icell = 0; icell < nglocal; icell++) {
+  for (int icell = cfirst; icell < clast; icell++) {
     np = cinfo[icell].count;
     if (np <= 1) continue;
+    if (cseed >= 0.0) cell_stream(icell);
 
     if (NEARCP) {
       if (np > max_nn) realloc_nn(np,nn_last_partner);
@@ -478,10 +784,16 @@ template < int NEARCP > void Collide::collisions_one()
       memory->create(plist,npmax,"collide:plist");
     }
 
-    n = 0;
-    while (ip >= 0) {
-      plist[n++] = ip;
-      ip = next[ip];
+    // if particles were reordered, cell owns contiguous range from ip
+
+    if (contiguous) {
+      for (n = 0; n < np; n++) plist[n] = ip+n;
+    } else {
+      n = 0;
+      while (ip >= 0) {
+        plist[n++] = ip;
+        ip = next[ip];
+      }
     }
 
     // attempt = exact collision attempt count for a pair of groups
@@ -493,6 +805,11 @@ template < int NEARCP > void Collide::collisions_one()
     if (!nattempt) continue;
     nattempt_one += nattempt;
 
+    if (batch) {
+      attempt_batch(icell,0,0,nattempt,plist,np,plist,np);
+      continue;
+    }
+
     // perform collisions
     // select random pair of particles, cannot be same
     // test if collision actually occurs
@@ -523,16 +840,16 @@ template < int NEARCP > void Collide::collisions_one()
       // unless boost factor turns it off, or there is no 3rd particle
 
       if (recombflag && recomb_ijflag[ipart->ispecies][jpart->ispecies]) {
-        if (random->uniform() > react->recomb_boost_inverse) 
-          react->recomb_species = -1;
+        if (random->uniform() > treact->recomb_boost_inverse) 
+          treact->recomb_species = -1;
         else if (np <= 2) 
-          react->recomb_species = -1;
+          treact->recomb_species = -1;
         else {
           k = np * random->uniform();
           while (k == i || k == j) k = np * random->uniform();
-          react->recomb_part3 = &particles[plist[k]];
-          react->recomb_species = react->recomb_part3->ispecies;
-          react->recomb_density = np * update->fnum / volume;
+          treact->recomb_part3 = &particles[plist[k]];
+          treact->recomb_species = treact->recomb_part3->ispecies;
+          treact->recomb_density = np * update->fnum / volume;
         }
       }
 
@@ -562,6 +879,7 @@ template < int NEARCP > void Collide::collisions_one()
       
       // if kpart created, add to plist
       // kpart was just added to particle list, so index = nlocal-1
+      // kpart = NULL if its creation was deferred by collisions_threaded()
       // particle data structs may have been realloced by kpart
       
       if (kpart) {
@@ -591,23 +909,26 @@ template < int NEARCP > void Collide::collisions_group()
   double attempt,volume;
   Particle::OnePart *ipart,*jpart,*kpart;
 
-  // loop over cells I own
+  // loop over cells I own, from cfirst to clast-1
 
   Grid::ChildInfo *cinfo = grid->cinfo;
 
   Particle::OnePart *particles = particle->particles;
   int *next = particle->next;
   int *species2group = mixture->species2group;
+  int contiguous = particle->contiguous;
 
-  for (int icell = 0; icell < nglocal; icell++) {
+  for (int icell = cfirst; icell < clast; icell++) {
     np = cinfo[icell].count;
     if (np <= 1) continue;
+    if (cseed >= 0.0) cell_stream(icell);
     ip = cinfo[icell].first;
     volume = cinfo[icell].volume / cinfo[icell].weight;
     if (volume == 0.0) error->one(FLERR,"Collision cell volume is zero");
 
     // if recombination is possible, setup particle list for entire cell
     // used to pick 3rd particle from entire cell, not just from IJgroups
+    // if particles were reordered, cell owns contiguous range from ip
 
     if (recombflag) {
       if (np > npmax) {
@@ -616,19 +937,23 @@ template < int NEARCP > void Collide::collisions_group()
         memory->create(plist,npmax,"collide:plist");
       }
 
-      n = 0;
-      while (ip >= 0) {
-        plist[n++] = ip;
-        ip = next[ip];
+      if (contiguous) {
+        for (n = 0; n < np; n++) plist[n] = ip+n;
+      } else {
+        n = 0;
+        while (ip >= 0) {
+          plist[n++] = ip;
+          ip = next[ip];
+        }
+        ip = cinfo[icell].first;         // reset ip to 1st particle in cell
       }
-      ip = cinfo[icell].first;         // reset ip to 1st particle in cell
     }
 
     // setup per-group particle lists for this cell
 
     for (i = 0; i < ngroups; i++) ngroup[i] = 0;
 
-    while (ip >= 0) {
+    for (n = 0; n < np; n++) {
       isp = particles[ip].ispecies;
       igroup = species2group[isp];
       if (ngroup[igroup] == maxgroup[igroup]) {
@@ -636,7 +961,8 @@ template < int NEARCP > void Collide::collisions_group()
 	memory->grow(glist[igroup],maxgroup[igroup],"collide:grouplist");
       }
       glist[igroup][ngroup[igroup]++] = ip;
-      ip = next[ip];
+      if (contiguous) ip++;
+      else ip = next[ip];
     }
 
     if (NEARCP) {
@@ -693,6 +1019,11 @@ template < int NEARCP > void Collide::collisions_group()
       if (*ni == 0 || *nj == 0) continue;
       if (igroup == jgroup && *ni == 1) continue;
 
+      if (batch) {
+        attempt_batch(icell,igroup,jgroup,nattempt,ilist,*ni,jlist,*nj);
+        continue;
+      }
+
       if (NEARCP) {
         nn_igroup = nn_last_partner_igroup;
         if (igroup == jgroup) nn_jgroup = nn_last_partner_igroup;
@@ -731,10 +1062,10 @@ template < int NEARCP > void Collide::collisions_group()
         //   recomb_species = -1 due to part3->ispecies = -1 when deleted
 
         if (recombflag && recomb_ijflag[ipart->ispecies][jpart->ispecies]) {
-          if (random->uniform() > react->recomb_boost_inverse) 
-            react->recomb_species = -1;
+          if (random->uniform() > treact->recomb_boost_inverse) 
+            treact->recomb_species = -1;
           else if (np <= 2) 
-            react->recomb_species = -1;
+            treact->recomb_species = -1;
           else {
             ii = ilist[i];
             jj = jlist[j];
@@ -744,9 +1075,9 @@ template < int NEARCP > void Collide::collisions_group()
               k = np * random->uniform();
               kk = plist[k];
             }
-            react->recomb_part3 = &particles[plist[k]];
-            react->recomb_species = react->recomb_part3->ispecies;
-            react->recomb_density = np * update->fnum / volume;
+            treact->recomb_part3 = &particles[plist[k]];
+            treact->recomb_species = treact->recomb_part3->ispecies;
+            treact->recomb_density = np * update->fnum / volume;
           }
         }
 
@@ -803,6 +1134,7 @@ template < int NEARCP > void Collide::collisions_group()
 
         // if kpart created, add to group list
 	// kpart was just added to particle list, so index = nlocal-1
+        // kpart = NULL if its creation was deferred by collisions_threaded()
         // reset ilist,jlist after addgroup() b/c may have been realloced
         // particles data struct may also have been realloced
 
@@ -853,6 +1185,109 @@ template < int NEARCP > void Collide::collisions_group()
   }
 }
 
+/* ----------------------------------------------------------------------
+   batched NTC attempts for one pair of groups in one grid cell
+   ilist/jlist = particle indices in each group, same list if igroup = jgroup
+   draw all candidate pairs and acceptance RNs up front,
+     then compute vre for all candidates at once,
+     then test them in order, recomputing vre for a candidate
+     if one of its particles already collided earlier in the batch
+   test outcomes are thus the same as testing one candidate at a time
+     with the same RNs, only the order RNs are drawn in differs
+   only used if no reactions, so particle lists do not change
+------------------------------------------------------------------------- */
+
+void Collide::attempt_batch(int icell, int igroup, int jgroup, int nattempt,
+                            int *ilist, int ni, int *jlist, int nj)
+{
+  int i,j,m;
+  Particle::OnePart *ipart,*jpart,*kpart;
+
+  if (nattempt > maxbatch) {
+    destroy_batch();
+    maxbatch = nattempt + DELTAPART;
+    memory->create(bi,maxbatch,"collide:bi");
+    memory->create(bj,maxbatch,"collide:bj");
+    bip = (Particle::OnePart **)
+      memory->smalloc(maxbatch*sizeof(Particle::OnePart *),"collide:bip");
+    bjp = (Particle::OnePart **)
+      memory->smalloc(maxbatch*sizeof(Particle::OnePart *),"collide:bjp");
+    memory->create(brn,maxbatch,"collide:brn");
+    memory->create(bvr2,maxbatch,"collide:bvr2");
+    memory->create(bvre,maxbatch,"collide:bvre");
+  }
+
+  if (ni+nj > maxmark) {
+    maxmark = ni+nj + DELTAPART;
+    memory->destroy(bmark);
+    memory->create(bmark,maxmark,"collide:bmark");
+  }
+
+  // select all candidate pairs, cannot be same particle
+
+  Particle::OnePart *particles = particle->particles;
+
+  for (m = 0; m < nattempt; m++) {
+    i = ni * random->uniform();
+    j = nj * random->uniform();
+    if (ilist == jlist)
+      while (i == j) j = nj * random->uniform();
+    bi[m] = i;
+    bj[m] = j;
+    bip[m] = &particles[ilist[i]];
+    bjp[m] = &particles[jlist[j]];
+  }
+
+  random->uniform(nattempt,brn);
+  vre_batch(nattempt,bip,bjp,bvr2,bvre);
+
+  // test candidates in order, perform collision for accepted ones
+  // imark/jmark flag particles whose velocity has changed in this batch
+
+  int *imark = bmark;
+  int *jmark = bmark;
+  if (ilist != jlist) jmark = &bmark[ni];
+  memset(bmark,0,(ni+nj)*sizeof(int));
+
+  for (m = 0; m < nattempt; m++) {
+    i = bi[m];
+    j = bj[m];
+    if (imark[i] || jmark[j])
+      vre_batch(1,&bip[m],&bjp[m],&bvr2[m],&bvre[m]);
+
+    if (!accept_collision(icell,igroup,jgroup,bvr2[m],bvre[m],brn[m])) 
+      continue;
+    imark[i] = jmark[j] = 1;
+
+    ipart = bip[m];
+    jpart = bjp[m];
+    setup_collision(ipart,jpart);
+    perform_collision(ipart,jpart,kpart);
+    ncollide_one++;
+  }
+}
+
+/* ----------------------------------------------------------------------
+   free arrays used by batched attempts
+------------------------------------------------------------------------- */
+
+void Collide::destroy_batch()
+{
+  memory->destroy(bi);
+  memory->destroy(bj);
+  memory->sfree(bip);
+  memory->sfree(bjp);
+  memory->destroy(brn);
+  memory->destroy(bvr2);
+  memory->destroy(bvre);
+  memory->destroy(bmark);
+  bi = bj = NULL;
+  bip = bjp = NULL;
+  brn = bvr2 = bvre = NULL;
+  bmark = NULL;
+  maxbatch = maxmark = 0;
+}
+
 /* ----------------------------------------------------------------------
    NTC algorithm for a single group with ambipolar approximation
 ------------------------------------------------------------------------- */
@@ -880,6 +1315,7 @@ void Collide::collisions_one_ambipolar()
   for (int icell = 0; icell < nglocal; icell++) {
     np = cinfo[icell].count;
     if (np <= 1) continue;
+    if (cseed >= 0.0) cell_stream(icell);
     ip = cinfo[icell].first;
     volume = cinfo[icell].volume / cinfo[icell].weight;
     if (volume == 0.0) error->one(FLERR,"Collision cell volume is zero");
@@ -1137,6 +1573,7 @@ void Collide::collisions_group_ambipolar()
   for (int icell = 0; icell < nglocal; icell++) {
     np = cinfo[icell].count;
     if (np <= 1) continue;
+    if (cseed >= 0.0) cell_stream(icell);
     ip = cinfo[icell].first;
     volume = cinfo[icell].volume / cinfo[icell].weight;
     if (volume == 0.0) error->one(FLERR,"Collision cell volume is zero");
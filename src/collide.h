@@ -30,6 +30,7 @@ class Collide : protected Pointers {
   int vibstyle;       // none/discrete/smooth vibrational modes
   int nearcp;         // 1 for near neighbor collisions
   int nearlimit;      // limit on neighbor serach for near neigh collisions
+  int batchflag;      // 1 for batched collision attempts
 
   int ncollide_one,nattempt_one,nreact_one;
   bigint ncollide_running,nattempt_running,nreact_running;
@@ -46,6 +47,14 @@ class Collide : protected Pointers {
   virtual double attempt_collision(int, int, int, double) = 0;
   virtual int test_collision(int, int, int, 
 			     Particle::OnePart *, Particle::OnePart *) = 0;
+
+  // only invoked if the style sets batchable, so styles need not batch
+
+  virtual void vre_batch(int, Particle::OnePart **, Particle::OnePart **,
+                         double *, double *) {}
+  virtual int accept_collision(int, int, int, double, double, double)
+    {return 0;}
+
   virtual void setup_collision(Particle::OnePart *, Particle::OnePart *) = 0;
   virtual int perform_collision(Particle::OnePart *&, Particle::OnePart *&, 
                                 Particle::OnePart *&) = 0;
@@ -87,6 +96,8 @@ class Collide : protected Pointers {
   char *mixID;               // ID of mixture to use for groups
   class Mixture *mixture;    // ptr to mixture
   class RanPark *random;     // RNG for collision generation
+  double cseed;              // key of counter-based RNG streams, -1 if unused
+  double rseed;              // ditto for RNG of React class
 
   int vre_first;      // 1 for first run after collision style is defined
   int vre_start;      // 1 if reset vre params at start of each run
@@ -120,6 +131,36 @@ class Collide : protected Pointers {
   int maxelectron;              // max # elist can hold
   Particle::OnePart *elist;     // list of ambipolar electrons
                                 // for one grid cell or pair of groups in cell
+  // batched collision attempts, only used for non-reacting, non-ambipolar,
+  //   non-nearcp models
+  // candidate pairs for one group pair in one cell are drawn up front
+  //   and their vre computed all at once
+
+  int batchable;                   // 1 if style implements vre_batch()
+                                   //   and accept_collision()
+  int batch;                       // 1 if batches are used this run
+  int maxbatch;                    // max # of candidates batch arrays hold
+  int *bi,*bj;                     // list indices of candidate particles
+  Particle::OnePart **bip,**bjp;   // ptrs to candidate particles
+  double *brn,*bvr2,*bvre;         // RN, vr^2, vre of each candidate
+  int maxmark;                     // max # of list indices bmark holds
+  int *bmark;                      // 1 if particle collided in this batch
+
+  // OpenMP threads, only used for non-ambipolar models
+  // each thread performs collisions for a contiguous chunk of cells
+  //   via its own copy of this class with its own RNG and scratch lists
+  //   and its own copy of React class
+  // particles created by reactions are deferred to per-thread lists
+
+  int nthreads;          // # of threads to perform collisions with
+  int cfirst,clast;      // range of owned cells collisions_one/group() loop over
+  Collide **tcollide;    // per-thread copies of this class, [0] = this
+  class React *treact;   // React class used by this thread, = react if serial
+
+  int deferflag;                 // 1 if created particles are deferred
+  int ncreate,maxcreate;         // # of deferred particles in createlist
+  Particle::OnePart *createlist; // particles created by chemistry
+
   // Kokkos data
 
   int oldgroups;         // pass from parent to child class
@@ -140,6 +181,15 @@ class Collide : protected Pointers {
 
   template < int > void collisions_one();
   template < int > void collisions_group();
+  void collisions_threaded();
+  void attempt_batch(int, int, int, int, int *, int, int *, int);
+  void destroy_batch();
+  void cell_stream(int);
+  void create_threads();
+  void destroy_threads();
+  Particle::OnePart *defer_particle(int, int, int, double *, double *);
+  virtual Collide *copy_thread() {return NULL;}
+
   void collisions_one_ambipolar();
   void collisions_group_ambipolar();
   void ambi_reset(int, int, int, int, Particle::OnePart *, Particle::OnePart *, 
@@ -173,10 +223,31 @@ E: Must use Kokkos-supported collision style if Kokkos is enabled
 
 Self-explanatory.
 
+E: Collision style does not support OpenMP threads
+
+The collision style must be able to make per-thread copies of itself
+if SPARTA was built with OpenMP.  Set OMP_NUM_THREADS to 1.
+
+E: Reaction style does not support OpenMP threads
+
+The reaction style must be able to make per-thread copies of itself
+if SPARTA was built with OpenMP.  Set OMP_NUM_THREADS to 1.
+
 E: Cannot (yet) use KOKKOS package with 'collide_modify vibrate discrete'
 
 This feature is not yet supported.
 
+W: Collision style does not support collide_modify batch
+
+The collision style cannot test attempts as a batch, so they are
+processed one at a time.
+
+W: Collide_modify batch is ignored with reactions, ambipolar, or nearcp
+
+Batched attempts require that particle lists do not change within a
+cell and that partners are chosen independently, so attempts are
+processed one at a time.
+
 E: Illegal ... command
 
 Self-explanatory.  Check the input script syntax and compare to the
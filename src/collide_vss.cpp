@@ -34,6 +34,7 @@ using namespace MathConst;
 
 enum{NONE,DISCRETE,SMOOTH};            // several files
 enum{CONSTANT,VARIABLE};
+enum{POW,SQRT,QUARTER};
 
 #define MAXLINE 1024
 
@@ -83,6 +84,27 @@ CollideVSS::CollideVSS(SPARTA *sparta, int narg, char **arg) :
   // allocate per-species prefactor array
 
   memory->create(prefactor,nparams,nparams,"collide:prefactor");
+
+  // vr^2 exponent for each species pair, 1 - average omega
+  // if same for all pairs and a power of 1/2, vre_batch() can use sqrt()
+
+  memory->create(vrexp,nparams,nparams,"collide:vrexp");
+  for (int i = 0; i < nparams; i++)
+    for (int j = 0; j < nparams; j++)
+      vrexp[i][j] = 1.0 - 0.5 * (params[i].omega+params[j].omega);
+
+  int same = 1;
+  for (int i = 0; i < nparams; i++)
+    for (int j = 0; j < nparams; j++)
+      if (vrexp[i][j] != vrexp[0][0]) same = 0;
+
+  vrexp_style = POW;
+  if (same && vrexp[0][0] == 0.5) vrexp_style = SQRT;
+  if (same && vrexp[0][0] == 0.25) vrexp_style = QUARTER;
+
+  // this style implements vre_batch() and accept_collision()
+
+  batchable = 1;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -93,6 +115,19 @@ CollideVSS::~CollideVSS()
 
   delete [] params;
   memory->destroy(prefactor);
+  memory->destroy(vrexp);
+}
+
+/* ----------------------------------------------------------------------
+   return a shallow copy of this class for use by one OpenMP thread
+   caller gives it its own RNG and scratch lists
+------------------------------------------------------------------------- */
+
+Collide *CollideVSS::copy_thread()
+{
+  CollideVSS *c = new CollideVSS(*this);
+  c->copymode = 1;
+  return c;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -212,10 +247,7 @@ int CollideVSS::test_collision(int icell, int igroup, int jgroup,
   double dv  = vi[1] - vj[1];
   double dw  = vi[2] - vj[2];
   double vr2 = du*du + dv*dv + dw*dw;
-  double omega1 = params[ispecies].omega;
-  double omega2 = params[jspecies].omega;
-  double omega = 0.5 * (omega1+omega2);
-  double vro  = pow(vr2,1.0-omega);
+  double vro  = pow(vr2,vrexp[ispecies][jspecies]);
 
   // although the vremax is calcualted for the group,
   // the individual collisions calculated species dependent vre
@@ -227,6 +259,53 @@ int CollideVSS::test_collision(int icell, int igroup, int jgroup,
   return 1;
 }
 
+/* ----------------------------------------------------------------------
+   compute vr2 and vre for N candidate pairs of particles
+   loops over contiguous arrays, so sqrt() variants can vectorize
+   sqrt(sqrt()) may differ from pow() in the last bit
+------------------------------------------------------------------------- */
+
+void CollideVSS::vre_batch(int n, Particle::OnePart **ip, 
+                           Particle::OnePart **jp, double *vr2, double *vre)
+{
+  int m;
+
+  for (m = 0; m < n; m++) {
+    double *vi = ip[m]->v;
+    double *vj = jp[m]->v;
+    double du  = vi[0] - vj[0];
+    double dv  = vi[1] - vj[1];
+    double dw  = vi[2] - vj[2];
+    vr2[m] = du*du + dv*dv + dw*dw;
+    vre[m] = prefactor[ip[m]->ispecies][jp[m]->ispecies];
+  }
+
+  if (vrexp_style == SQRT) {
+    for (m = 0; m < n; m++) vre[m] *= sqrt(vr2[m]);
+  } else if (vrexp_style == QUARTER) {
+    for (m = 0; m < n; m++) vre[m] *= sqrt(sqrt(vr2[m]));
+  } else {
+    for (m = 0; m < n; m++) 
+      vre[m] *= pow(vr2[m],vrexp[ip[m]->ispecies][jp[m]->ispecies]);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   determine if collision occurs for a pair with vr2,vre from vre_batch()
+   rn = RN to compare to
+   1 = yes, 0 = no
+   update vremax either way
+------------------------------------------------------------------------- */
+
+int CollideVSS::accept_collision(int icell, int igroup, int jgroup,
+                                 double vr2, double vre, double rn)
+{
+  vremax[icell][igroup][jgroup] = MAX(vre,vremax[icell][igroup][jgroup]);
+  if (vre/vremax[icell][igroup][jgroup] < rn) return 0;
+  precoln.vr2 = vr2;
+  return 1;
+}
+
 /* ---------------------------------------------------------------------- */
 
 void CollideVSS::setup_collision(Particle::OnePart *ip, Particle::OnePart *jp)
@@ -284,7 +363,7 @@ int CollideVSS::perform_collision(Particle::OnePart *&ip,
   // if 2nd particle is removed, its jspecies is set to -1
 
   if (react) 
-    reactflag = react->attempt(ip,jp,
+    reactflag = treact->attempt(ip,jp,
                                precoln.etrans,precoln.erot,
                                precoln.evib,postcoln.etotal,kspecies);
   else reactflag = 0;
@@ -301,23 +380,30 @@ int CollideVSS::perform_collision(Particle::OnePart *&ip,
     // index of new K particle = nlocal-1
     // if add_particle() performs a realloc:
     //   make copy of x,v, then repoint ip,jp to new particles data struct
+    // if deferred by threads, K particle is stored in create list instead
+    //   and returned kp = NULL, so caller does not add it to its lists
 
     if (kspecies >= 0) {
       int id = MAXSMALLINT*random->uniform();
 
-      Particle::OnePart *particles = particle->particles;
-      memcpy(x,ip->x,3*sizeof(double));
-      memcpy(v,ip->v,3*sizeof(double));
-      int reallocflag = 
-        particle->add_particle(id,kspecies,ip->icell,x,v,0.0,0.0);
-      if (reallocflag) {
-        ip = particle->particles + (ip - particles);
-        jp = particle->particles + (jp - particles);
+      if (deferflag) {
+        kp = defer_particle(id,kspecies,ip->icell,ip->x,ip->v);
+      } else {
+        Particle::OnePart *particles = particle->particles;
+        memcpy(x,ip->x,3*sizeof(double));
+        memcpy(v,ip->v,3*sizeof(double));
+        int reallocflag = 
+          particle->add_particle(id,kspecies,ip->icell,x,v,0.0,0.0);
+        if (reallocflag) {
+          ip = particle->particles + (ip - particles);
+          jp = particle->particles + (jp - particles);
+        }
+        kp = &particle->particles[particle->nlocal-1];
       }
 
-      kp = &particle->particles[particle->nlocal-1];
       EEXCHANGE_ReactingEDisposal(ip,jp,kp);
       SCATTER_ThreeBodyScattering(ip,jp,kp);
+      if (deferflag) kp = NULL;
 
     // remove 2nd J particle if recombination reaction removed it
     // p3 is 3rd particle participating in energy exchange
@@ -336,7 +422,7 @@ int CollideVSS::perform_collision(Particle::OnePart *&ip,
       vi[2] = wcmf;
 
       jp = NULL;
-      p3 = react->recomb_part3;
+      p3 = treact->recomb_part3;
 
       // properly account for 3rd body energy with another call to setup_collision()
       // it needs relative velocity of recombined species and 3rd body
@@ -36,6 +36,9 @@ class CollideVSS : public Collide {
   virtual double attempt_collision(int, int, double);
   double attempt_collision(int, int, int, double);
   virtual int test_collision(int, int, int, Particle::OnePart *, Particle::OnePart *);
+  void vre_batch(int, Particle::OnePart **, Particle::OnePart **, 
+                 double *, double *);
+  int accept_collision(int, int, int, double, double, double);
   virtual void setup_collision(Particle::OnePart *, Particle::OnePart *);
   virtual int perform_collision(Particle::OnePart *&, Particle::OnePart *&, 
                         Particle::OnePart *&);
@@ -76,6 +79,8 @@ class CollideVSS : public Collide {
   int relaxflag,eng_exchange;
   double vr_indice;
   double **prefactor; // static portion of collision attempt frequency
+  double **vrexp;     // exponent of vr^2 in vre for each species pair
+  int vrexp_style;    // exponent shared by all species pairs, if any
  
   struct State precoln;       // state before collision
   struct State postcoln;      // state after collision
@@ -95,6 +100,7 @@ class CollideVSS : public Collide {
                                    Particle::OnePart *);
 
   double sample_bl(RanPark *, double, double);
+  Collide *copy_thread();
   double rotrel (int, double);  
   double vibrel (int, double);  
 
@@ -30,6 +30,9 @@ using namespace SPARTA_NS;
 
 enum{PKEEP,PINSERT,PDONE,PDISCARD,PENTRY,PEXIT,PSURF};   // several files
 
+#define BUFFACTOR 1.5
+#define BUFMIN 1000
+
 /* ---------------------------------------------------------------------- */
 
 Comm::Comm(SPARTA *sparta) : Pointers(sparta)
@@ -40,10 +43,24 @@ Comm::Comm(SPARTA *sparta) : Pointers(sparta)
   ncomm = 0;
   commsortflag = 0;
   commpartstyle = 1;
+  npipe = 1;
+  sharedflag = 0;
 
   neighflag = 0;
   neighlist = NULL;
 
+  nodecomm = MPI_COMM_NULL;
+  nodeme = 0;
+  nnode = 1;
+  node_rank = node_proc = node_count = NULL;
+  shwinflag = 0;
+  shcap = shheader = 0;
+  shseg = NULL;
+  ioffnode = NULL;
+  offnodeflag = 0;
+  offsrc = NULL;
+  maxoffsrc = 0;
+
   iparticle = new Irregular(sparta);
   igrid = NULL;
   iuniform = NULL;
@@ -55,6 +72,9 @@ Comm::Comm(SPARTA *sparta) : Pointers(sparta)
   sbuf = rbuf = NULL;
   maxsendbuf = maxrecvbuf = 0;
 
+  migrate_flag = migrate_weight = 1;
+  nbytes_migrate = sizeof(Particle::OnePart);
+
   copymode = 0;
 }
 
@@ -75,6 +95,18 @@ Comm::~Comm()
   memory->destroy(rbuf);
 
   memory->destroy(neighlist);
+
+  if (shwinflag) {
+    MPI_Win_unlock_all(shwin);
+    MPI_Win_free(&shwin);
+  }
+  if (nodecomm != MPI_COMM_NULL) MPI_Comm_free(&nodecomm);
+  memory->destroy(node_rank);
+  memory->destroy(node_proc);
+  memory->destroy(node_count);
+  delete [] shseg;
+  delete ioffnode;
+  memory->destroy(offsrc);
 }
 
 /* ----------------------------------------------------------------------
@@ -107,6 +139,9 @@ void Comm::reset_neighbors()
     if (neighlist[i]) neighlist[nneigh++] = i;
   
   iparticle->create_procs(nneigh,neighlist,commsortflag);
+
+  offnodeflag = 0;
+  if (sharedflag) offnode_neighbors();
 }
 
 /* ----------------------------------------------------------------------
@@ -116,16 +151,100 @@ void Comm::reset_neighbors()
 ------------------------------------------------------------------------- */
 
 int Comm::migrate_particles(int nmigrate, int *plist)
+{
+  int nbytes = migrate_format() + particle->sizeof_custom();
+
+  // pack sbuf with particles to migrate
+
+  int nsend = pack_migrate(nmigrate,plist);
+
+  // compress my list of particles
+
+  particle->compress_migrate(nmigrate,plist);
+  int ncompress = particle->nlocal;
+
+  // if sharing memory with other procs on my node,
+  //   write migrants to them into shared window, only off-node remain in sbuf
+  //   use neighbor plan with off-node procs only
+
+  Irregular *irregular = iparticle;
+
+  int shared = 0;
+  if (sharedflag) {
+    shared_setup();
+    if (nnode > 1) shared = 1;
+  }
+
+  if (shared) {
+    nsend = shared_send(nsend,nbytes);
+    if (neighflag) {
+      if (!offnodeflag) offnode_neighbors();
+      irregular = ioffnode;
+    }
+  }
+
+  // create or augment irregular communication plan
+  // nrecv = # of incoming particles
+  
+  int nrecv;
+  if (neighflag)
+    nrecv = irregular->augment_data_uniform(nsend,pproc);
+  else 
+    nrecv = irregular->create_data_uniform(nsend,pproc,commsortflag);
+
+  // perform irregular communication
+  // receive into rbuf, unpack particles one by one via unpack_migrate()
+  // if shared, also unpack migrants from procs on my node
+
+  if (nrecv*nbytes > maxrecvbuf) {
+    maxrecvbuf = nrecv*nbytes;
+    memory->destroy(rbuf);
+    memory->create(rbuf,maxrecvbuf,"comm:rbuf");
+  }
+
+  irregular->exchange_uniform(sbuf,nbytes,rbuf);
+
+  if (shared) {
+    int nshared = shared_recv();
+    particle->grow(nrecv+nshared);
+    if (commsortflag) {
+      if (nrecv > maxoffsrc) {
+        maxoffsrc = nrecv;
+        memory->destroy(offsrc);
+        memory->create(offsrc,maxoffsrc,"comm:offsrc");
+      }
+      irregular->reverse(nrecv,offsrc);
+    }
+    shared_unpack(nrecv,nbytes);
+  } else {
+    particle->grow(nrecv);
+    unpack_migrate(nrecv,rbuf);
+  }
+
+  ncomm += nsend;
+  return ncompress;
+}
+
+/* ----------------------------------------------------------------------
+   pack particles in plist that migrate into sbuf, set pproc for each
+   if flag == PDISCARD, particle is deleted but not sent
+   change icell of migrated particle to owning cell on receiving proc
+   if no custom attributes, pack particles directly via memcpy()
+   else pack_custom() performs packing into sbuf
+   return nsend = # of particles that actually migrate
+------------------------------------------------------------------------- */
+
+int Comm::pack_migrate(int nmigrate, int *plist)
 {
   int i,j;
+  char *ptr;
 
   Grid::ChildCell *cells = grid->cells;
   Particle::OnePart *particles = particle->particles;
 
   int ncustom = particle->ncustom;
-  int nbytes_particle = sizeof(Particle::OnePart);
   int nbytes_custom = particle->sizeof_custom();
-  int nbytes = nbytes_particle + nbytes_custom;
+  int nbytes = nbytes_migrate + nbytes_custom;
 
   // grow pproc and sbuf if necessary
 
@@ -140,88 +259,372 @@ int Comm::migrate_particles(int nmigrate, int *plist)
     memory->create(sbuf,maxsendbuf,"comm:sbuf");
   }
 
-  // fill proclist with procs to send to
-  // pack sbuf with particles to migrate
-  // if flag == PDISCARD, particle is deleted but not sent
-  // change icell of migrated particle to owning cell on receiving proc
-  // nsend = particles that actually migrate
-  // if no custom attributes, pack particles directly via memcpy()
-  // else pack_custom() performs packing into sbuf
+  // copy the fields of migrate_format() in the order of OnePart
+  // id,ispecies,icell,flag are contiguous, as are x,v,erot,evib,dtremain
+
+  int nbytes_int = 3*sizeof(int);
+  int nbytes_double = 8*sizeof(double);
+  if (migrate_flag) {
+    nbytes_int += sizeof(int);
+    nbytes_double += sizeof(double);
+  }
 
   int nsend = 0;
   int offset = 0;
 
-  if (!ncustom) {
-    for (i = 0; i < nmigrate; i++) {
-      j = plist[i];
-      if (particles[j].flag == PDISCARD) continue;
-      pproc[nsend++] = cells[particles[j].icell].proc;
-      particles[j].icell = cells[particles[j].icell].ilocal;
-      memcpy(&sbuf[offset],&particles[j],nbytes_particle);
-      offset += nbytes_particle;
-    }
-  } else {
-    for (i = 0; i < nmigrate; i++) {
-      j = plist[i];
-      if (particles[j].flag == PDISCARD) continue;
-      pproc[nsend++] = cells[particles[j].icell].proc;
-      particles[j].icell = cells[particles[j].icell].ilocal;
-      memcpy(&sbuf[offset],&particles[j],nbytes_particle);
-      offset += nbytes_particle;
+  for (i = 0; i < nmigrate; i++) {
+    j = plist[i];
+    if (particles[j].flag == PDISCARD) continue;
+    pproc[nsend++] = cells[particles[j].icell].proc;
+    particles[j].icell = cells[particles[j].icell].ilocal;
+    ptr = &sbuf[offset];
+    memcpy(ptr,&particles[j].id,nbytes_int);
+    ptr += nbytes_int;
+    memcpy(ptr,particles[j].x,nbytes_double);
+    ptr += nbytes_double;
+    if (migrate_weight) memcpy(ptr,&particles[j].weight,sizeof(double));
+    offset += nbytes_migrate;
+    if (ncustom) {
       particle->pack_custom(j,&sbuf[offset]);
       offset += nbytes_custom;
     }
   }
 
-  // compress my list of particles
+  return nsend;
+}
 
-  particle->compress_migrate(nmigrate,plist);
-  int ncompress = particle->nlocal;
+/* ----------------------------------------------------------------------
+   unpack N received particles in buf, append them to particle list
+   fields not sent by pack_migrate() are reset:
+     flag = PDONE, since receiver does not continue the move, dtremain = 0.0
+     weight = 0.0, since it is only used when set by Particle::pre_weight()
+------------------------------------------------------------------------- */
 
-  // create or augment irregular communication plan
-  // nrecv = # of incoming particles
-  
-  int nrecv;
-  if (neighflag)
-    nrecv = iparticle->augment_data_uniform(nsend,pproc);
-  else 
-    nrecv = iparticle->create_data_uniform(nsend,pproc,commsortflag);
+void Comm::unpack_migrate(int n, char *buf)
+{
+  char *ptr;
 
-  // extend particle list if necessary
+  int ncustom = particle->ncustom;
+  int nbytes_custom = particle->sizeof_custom();
 
-  particle->grow(nrecv);
+  int nbytes_int = 3*sizeof(int);
+  int nbytes_double = 8*sizeof(double);
+  if (migrate_flag) {
+    nbytes_int += sizeof(int);
+    nbytes_double += sizeof(double);
+  }
 
-  // perform irregular communication
-  // if no custom attributes, append recv particles directly to particle list
-  // else receive into rbuf, unpack particles one by one via unpack_custom()
+  int offset = 0;
+  int nlocal = particle->nlocal;
+  Particle::OnePart *particles = particle->particles;
+
+  for (int i = 0; i < n; i++) {
+    Particle::OnePart *p = &particles[nlocal];
+    ptr = &buf[offset];
+    memcpy(&p->id,ptr,nbytes_int);
+    ptr += nbytes_int;
+    memcpy(p->x,ptr,nbytes_double);
+    ptr += nbytes_double;
+    if (!migrate_flag) {
+      p->flag = PDONE;
+      p->dtremain = 0.0;
+    }
+    if (migrate_weight) memcpy(&p->weight,ptr,sizeof(double));
+    else p->weight = 0.0;
+    offset += nbytes_migrate;
+    if (ncustom) {
+      particle->unpack_custom(&buf[offset],nlocal);
+      offset += nbytes_custom;
+    }
+    nlocal++;
+  }
 
-  if (!ncustom)
-    iparticle->
-      exchange_uniform(sbuf,nbytes,
-                       (char *) &particle->particles[particle->nlocal]);
+  particle->nlocal = nlocal;
+}
 
-  else {
-    if (nrecv*nbytes > maxrecvbuf) {
-      maxrecvbuf = nrecv*nbytes;
-      memory->destroy(rbuf);
-      memory->create(rbuf,maxrecvbuf,"comm:rbuf");
+/* ----------------------------------------------------------------------
+   setup for shared-memory migration with procs on my node
+   only done once, since procs sharing memory never change
+------------------------------------------------------------------------- */
+
+void Comm::shared_setup()
+{
+  if (nodecomm != MPI_COMM_NULL) return;
+
+  MPI_Comm_split_type(world,MPI_COMM_TYPE_SHARED,me,MPI_INFO_NULL,&nodecomm);
+  MPI_Comm_rank(nodecomm,&nodeme);
+  MPI_Comm_size(nodecomm,&nnode);
+
+  memory->create(node_proc,nnode,"comm:node_proc");
+  memory->create(node_count,nnode,"comm:node_count");
+  memory->create(node_rank,nprocs,"comm:node_rank");
+  shseg = new char*[nnode];
+
+  MPI_Allgather(&me,1,MPI_INT,node_proc,1,MPI_INT,nodecomm);
+  for (int i = 0; i < nprocs; i++) node_rank[i] = -1;
+  for (int i = 0; i < nnode; i++) node_rank[node_proc[i]] = i;
+
+  shheader = IROUNDUP(2*nnode*sizeof(int));
+}
+
+/* ----------------------------------------------------------------------
+   (re)allocate shared window with nbytes of migrant data per segment
+   collective on nodecomm, all procs must be done reading old window
+------------------------------------------------------------------------- */
+
+void Comm::shared_window(int nbytes)
+{
+  if (shwinflag) {
+    MPI_Win_unlock_all(shwin);
+    MPI_Win_free(&shwin);
+  }
+
+  shcap = nbytes;
+  char *ptr;
+  MPI_Win_allocate_shared((MPI_Aint) shheader+shcap,1,MPI_INFO_NULL,
+                          nodecomm,&ptr,&shwin);
+  MPI_Win_lock_all(MPI_MODE_NOCHECK,shwin);
+  shwinflag = 1;
+
+  MPI_Aint size;
+  int disp;
+  for (int i = 0; i < nnode; i++)
+    MPI_Win_shared_query(shwin,i,&size,&disp,&shseg[i]);
+}
+
+/* ----------------------------------------------------------------------
+   create neighbor plan for particle comm with only procs not on my node
+------------------------------------------------------------------------- */
+
+void Comm::offnode_neighbors()
+{
+  shared_setup();
+  if (!ioffnode) ioffnode = new Irregular(sparta);
+
+  int *offlist = new int[nneigh];
+  int noff = 0;
+  for (int i = 0; i < nneigh; i++)
+    if (node_rank[neighlist[i]] < 0) offlist[noff++] = neighlist[i];
+
+  ioffnode->create_procs(noff,offlist,commsortflag);
+  delete [] offlist;
+  offnodeflag = 1;
+}
+
+/* ----------------------------------------------------------------------
+   write packed migrants in sbuf going to procs on my node to my segment
+   grouped by node proc, in the order they appear in sbuf
+   compress sbuf and pproc to off-node migrants
+   nsend = # of migrants in sbuf, nbytes = size of each
+   return # of off-node migrants
+------------------------------------------------------------------------- */
+
+int Comm::shared_send(int nsend, int nbytes)
+{
+  int i,irank;
+
+  for (i = 0; i < nnode; i++) node_count[i] = 0;
+  for (i = 0; i < nsend; i++) {
+    irank = node_rank[pproc[i]];
+    if (irank >= 0) node_count[irank]++;
+  }
+
+  int nshared = 0;
+  for (i = 0; i < nnode; i++) nshared += node_count[i];
+
+  // all node procs must be done reading window from previous migration
+  //   before anyone writes to it, Allreduce also insures that
+  // grow window if any node proc needs more room
+  // Allreduce and Barrier in shared_recv() are done even if nshared = 0,
+  //   since other node procs may send to me
+
+  bigint need = (bigint) nshared*nbytes;
+  bigint maxneed;
+  MPI_Allreduce(&need,&maxneed,1,MPI_SPARTA_BIGINT,MPI_MAX,nodecomm);
+
+  if (!shwinflag || maxneed > shcap) {
+    bigint newcap = MAX(BUFMIN,(bigint) (BUFFACTOR*maxneed));
+    if (newcap > MAXSMALLINT-shheader)
+      error->one(FLERR,"Shared memory migration buffer exceeds 2 GB");
+    shared_window(newcap);
+  }
+
+  // header = count and offset of migrants to each node proc
+
+  int *header = (int *) shseg[nodeme];
+  char *data = shseg[nodeme] + shheader;
+
+  int offset = 0;
+  for (i = 0; i < nnode; i++) {
+    header[i] = node_count[i];
+    header[nnode+i] = offset;
+    offset += node_count[i]*nbytes;
+  }
+
+  int noff = 0;
+  for (i = 0; i < nsend; i++) {
+    irank = node_rank[pproc[i]];
+    if (irank >= 0) {
+      memcpy(&data[header[nnode+irank]],&sbuf[i*nbytes],nbytes);
+      header[nnode+irank] += nbytes;
+    } else {
+      if (noff != i) {
+        memcpy(&sbuf[noff*nbytes],&sbuf[i*nbytes],nbytes);
+        pproc[noff] = pproc[i];
+      }
+      noff++;
     }
+  }
 
-    iparticle->exchange_uniform(sbuf,nbytes,rbuf);
+  for (i = 0; i < nnode; i++) header[nnode+i] -= node_count[i]*nbytes;
 
-    offset = 0;
-    int nlocal = particle->nlocal;
-    for (i = 0; i < nrecv; i++) {
-      memcpy(&particle->particles[nlocal],&rbuf[offset],nbytes_particle);
-      offset += nbytes_particle;
-      particle->unpack_custom(&rbuf[offset],nlocal);
-      offset += nbytes_custom;
-      nlocal++;
+  MPI_Win_sync(shwin);
+  return noff;
+}
+
+/* ----------------------------------------------------------------------
+   wait until all node procs have written their segment
+   set node_count = # of migrants each node proc sends me
+   return total # of migrants I recv from node procs
+------------------------------------------------------------------------- */
+
+int Comm::shared_recv()
+{
+  MPI_Barrier(nodecomm);
+  MPI_Win_sync(shwin);
+
+  int nshared = 0;
+  for (int i = 0; i < nnode; i++) {
+    node_count[i] = ((int *) shseg[i])[nodeme];
+    nshared += node_count[i];
+  }
+
+  return nshared;
+}
+
+/* ----------------------------------------------------------------------
+   append migrants received via rbuf and via shared window to particle list
+   noff = # of off-node migrants in rbuf, nbytes = size of each
+   if commsortflag, order by sending proc, using offsrc for off-node ones,
+     so list is same as if all were received by irregular comm
+   else off-node migrants first, then on-node by node proc
+------------------------------------------------------------------------- */
+
+void Comm::shared_unpack(int noff, int nbytes)
+{
+  int i,j,irank,offset;
+
+  if (!commsortflag) {
+    unpack_migrate(noff,rbuf);
+    for (irank = 0; irank < nnode; irank++) {
+      if (!node_count[irank]) continue;
+      offset = ((int *) shseg[irank])[nnode+nodeme];
+      unpack_migrate(node_count[irank],shseg[irank]+shheader+offset);
     }
+    return;
   }
 
-  particle->nlocal += nrecv;
+  i = 0;
+  irank = 0;
+  while (i < noff || irank < nnode) {
+    if (irank < nnode && !node_count[irank]) {
+      irank++;
+      continue;
+    }
+    if (i < noff && (irank == nnode || offsrc[i] < node_proc[irank])) {
+      j = i;
+      while (j < noff && offsrc[j] == offsrc[i]) j++;
+      unpack_migrate(j-i,&rbuf[i*nbytes]);
+      i = j;
+    } else {
+      offset = ((int *) shseg[irank])[nnode+nodeme];
+      unpack_migrate(node_count[irank],shseg[irank]+shheader+offset);
+      irank++;
+    }
+  }
+}
+
+/* ----------------------------------------------------------------------
+   set compact wire format for migrating particles
+   always send id,ispecies,icell,x,v,erot,evib
+   flag,dtremain are only needed if the receiver continues the move,
+     never the case for gridcut < 0.0, where all migrants are flagged PDONE
+   weight is only needed if grid-based particle weighting is ON
+   round size to 8 bytes, so custom data which follows is aligned
+   return # of bytes per particle, not including custom data
+------------------------------------------------------------------------- */
+
+int Comm::migrate_format()
+{
+  migrate_flag = 1;
+  if (grid->cutoff < 0.0) migrate_flag = 0;
+  migrate_weight = 0;
+  if (grid->cellweightflag) migrate_weight = 1;
+
+  int n = 3*sizeof(int) + 8*sizeof(double);
+  if (migrate_flag) n += sizeof(int) + sizeof(double);
+  if (migrate_weight) n += sizeof(double);
+  nbytes_migrate = IROUNDUP(n);
+
+  return nbytes_migrate;
+}
+
+/* ----------------------------------------------------------------------
+   start pipelined migration of particles during a particle move
+   Update::move() moves particles in npipe chunks,
+     calls migrate_pipe_chunk() after each, migrate_pipe_finish() at end
+   only possible with nearest-neighbor particle comm
+   return 1 if pipelining is performed, 0 if not
+------------------------------------------------------------------------- */
+
+int Comm::migrate_pipe_start()
+{
+  if (npipe <= 1 || !neighflag) return 0;
+
+  int nbytes = migrate_format() + particle->sizeof_custom();
+  iparticle->pipe_start(npipe,nbytes);
+  return 1;
+}
+
+/* ----------------------------------------------------------------------
+   send particles in plist that migrate from one chunk of the move
+   they remain in particle list until migrate_pipe_finish()
+------------------------------------------------------------------------- */
+
+void Comm::migrate_pipe_chunk(int nmigrate, int *plist)
+{
+  int nsend = pack_migrate(nmigrate,plist);
+  iparticle->pipe_send(nsend,pproc,sbuf);
   ncomm += nsend;
+}
+
+/* ----------------------------------------------------------------------
+   complete pipelined migration
+   plist = all particles in plist of every chunk, in ascending order
+   compress my list and append received particles, in same order
+     as migrate_particles() would for a single exchange
+   return particle nlocal after compression, same as migrate_particles()
+------------------------------------------------------------------------- */
+
+int Comm::migrate_pipe_finish(int nmigrate, int *plist)
+{
+  int nrecv = iparticle->pipe_wait();
+
+  particle->compress_migrate(nmigrate,plist);
+  int ncompress = particle->nlocal;
+
+  particle->grow(nrecv);
+
+  int nbytes = nbytes_migrate + particle->sizeof_custom();
+  if (nrecv*nbytes > maxrecvbuf) {
+    maxrecvbuf = nrecv*nbytes;
+    memory->destroy(rbuf);
+    memory->create(rbuf,maxrecvbuf,"comm:rbuf");
+  }
+
+  iparticle->pipe_unpack(rbuf);
+  unpack_migrate(nrecv,rbuf);
+
   return ncompress;
 }
 
@@ -30,12 +30,19 @@ class Comm : protected Pointers {
   int commpartstyle;                // 1 for neighbor, 0 for all
                                     //   changes how irregular comm for
                                     //   particles is performed
+  int npipe;                        // # of chunks to pipeline particle
+                                    //   move and migration in, 1 = none
+  int sharedflag;                   // 1 to migrate particles to procs on
+                                    //   same node via shared memory
 
   Comm(class SPARTA *);
   ~Comm();
   void init() {}
   void reset_neighbors();
   int migrate_particles(int, int *);
+  int migrate_pipe_start();
+  void migrate_pipe_chunk(int, int *);
+  int migrate_pipe_finish(int, int *);
   virtual void migrate_cells(int);
   int send_cells_adapt(int, int *, char *, char **);
   int irregular_uniform_neighs(int, int *, char *, int, char **);
@@ -54,13 +61,48 @@ class Comm : protected Pointers {
   int maxpproc,maxgproc;
   bigint rvous_bytes;
   
+  // compact wire format of a migrating particle, set by migrate_format()
+
+  int migrate_flag;                 // 1 if flag,dtremain are sent
+  int migrate_weight;               // 1 if weight is sent
+  int nbytes_migrate;               // bytes per particle, w/out custom data
+
   int neighflag;                    // 1 if nearest-neighbor particle comm
   int nneigh;                       // # of procs I own ghost cells of
   int *neighlist;                   // list of ghost procs
 
+  // shared-memory migration of particles to procs on same node
+  // each node proc writes its migrants to its segment of a shared window
+  // segment = count and byte offset of migrants to each node proc, then data
+
+  MPI_Comm nodecomm;                // procs on my node, ordered by world rank
+  int nodeme,nnode;                 // my rank and # of procs in nodecomm
+  int *node_rank;                   // rank in nodecomm of each world proc,
+                                    //   -1 if not on my node
+  int *node_proc;                   // world proc of each rank in nodecomm
+  int *node_count;                  // # of migrants to each node proc
+  MPI_Win shwin;                    // shared window, 1 segment per node proc
+  int shwinflag;                    // 1 if shwin is allocated
+  int shcap;                        // bytes of migrant data per segment
+  int shheader;                     // bytes of counts/offsets per segment
+  char **shseg;                     // ptr to segment of each node proc
+  class Irregular *ioffnode;        // neighbor plan with off-node procs only
+  int offnodeflag;                  // 1 if ioffnode plan is current
+  int *offsrc;                      // source proc of each off-node migrant
+  int maxoffsrc;                    // length of offsrc
+
   int copymode;                 // 1 if copy of class (prevents deallocation of
                                 // base class when child copy is destroyed)
 
+  int migrate_format();
+  int pack_migrate(int, int *);
+  void unpack_migrate(int, char *);
+  void shared_setup();
+  void shared_window(int);
+  void offnode_neighbors();
+  int shared_send(int, int);
+  int shared_recv();
+  void shared_unpack(int, int);
   void migrate_cells_less_memory(int);  // small memory version of migrate_cells
   int rendezvous_irregular(int, char *, int, int, int *, 
                            int (*)(int, char *, int &, int *&, char *&, void *), 
@@ -82,4 +124,9 @@ E: Migrate cells send buffer exceeds 2 GB
 MPI does not support a communication buffer that exceeds a 4-byte
 integer in size.
 
+E: Shared memory migration buffer exceeds 2 GB
+
+The particles migrating to procs on the same node in one step require
+a larger buffer than a 4-byte integer can index.
+
 */
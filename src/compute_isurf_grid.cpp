@@ -86,14 +86,15 @@ ComputeISurfGrid::ComputeISurfGrid(SPARTA *sparta, int narg, char **arg) :
   ntally = maxtally = 0;
   array_surf_tally = NULL;
   tally2surf = NULL;
+  ncell2tally = 0;
+  cell2tally = NULL;
+  tally2cell = NULL;
 
   maxgrid = 0;
   array_grid = NULL;
   normflux = NULL;
   combined = 0;
 
-  hash = new MyHash;
-
   dim = domain->dimension;
 }
 
@@ -104,9 +105,10 @@ ComputeISurfGrid::~ComputeISurfGrid()
   delete [] which;
   memory->destroy(array_surf_tally);
   memory->destroy(tally2surf);
+  memory->destroy(cell2tally);
+  memory->destroy(tally2cell);
   memory->destroy(array_grid);
   memory->destroy(normflux);
-  delete hash;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -122,9 +124,10 @@ void ComputeISurfGrid::init()
     error->all(FLERR,
                "Number of groups in compute isurf/grid mixture has changed");
 
-  // set normflux for all owned + ghost surfs
+  // set normflux and cell2tally for all owned + ghost cells
 
   init_normflux();
+  init_cell2tally();
 
   // set weightflag if cell weighting is enabled
   // else weight = 1.0 for all particles
@@ -194,11 +197,15 @@ void ComputeISurfGrid::clear()
 {
   lines = surf->lines;
   tris = surf->tris;
+  cells = grid->cells;
+  sinfo = grid->sinfo;
 
-  // clear hash of tallied surf IDs
+  // reset cell2tally for cells tallied since last clear
+  // skip stale indices if cell2tally was re-initialized since then
   // called by Update at beginning of timesteps surf tallying is done
 
-  hash->clear();
+  for (int i = 0; i < ntally; i++)
+    if (tally2cell[i] < ncell2tally) cell2tally[tally2cell[i]] = -1;
   ntally = 0;
   combined = 0;
 }
@@ -225,8 +232,8 @@ void ComputeISurfGrid::surf_tally(int isurf, int icell, int reaction,
   int igroup = particle->mixture[imix]->species2group[origspecies];
   if (igroup < 0) return;
 
-  // itally = tally index of isurf
-  // if 1st particle hitting isurf, add surf ID to hash
+  // itally = tally index of the grid cell containing isurf
+  // if 1st particle hitting a surf in the cell, assign it next tally index
   // grow tally list if needed
   // for implicit surfs, surfID is really a cellID
 
@@ -237,12 +244,19 @@ void ComputeISurfGrid::surf_tally(int isurf, int icell, int reaction,
   if (dim == 2) surfID = lines[isurf].id;
   else surfID = tris[isurf].id;
 
-  if (hash->find(surfID) != hash->end()) itally = (*hash)[surfID];
-  else {
+  // implicit surfs in a sub cell are tallied by their split cell
+
+  int jcell = icell;
+  if (jcell < grid->nlocal && cells[jcell].nsplit <= 0)
+    jcell = sinfo[cells[jcell].isplit].icell;
+
+  itally = cell2tally[jcell];
+  if (itally < 0) {
     if (ntally == maxtally) grow_tally();
     itally = ntally;
-    (*hash)[surfID] = itally;
+    cell2tally[jcell] = itally;
     tally2surf[itally] = surfID;
+    tally2cell[itally] = jcell;
     vec = array_surf_tally[itally];
     for (int i = 0; i < ntotal; i++) vec[i] = 0.0;
     ntally++;
@@ -504,23 +518,39 @@ void ComputeISurfGrid::post_process_isurf_grid()
   }
 }
 
+/* ----------------------------------------------------------------------
+   reset cell2tally to -1 for all owned + ghost grid cells
+   called by init before each run and whenever grid changes,
+     since local indices of cells may then have changed
+------------------------------------------------------------------------- */
+
+void ComputeISurfGrid::init_cell2tally()
+{
+  ncell2tally = grid->nlocal + grid->nghost;
+  memory->destroy(cell2tally);
+  memory->create(cell2tally,ncell2tally,"isurf/grid:cell2tally");
+  for (int i = 0; i < ncell2tally; i++) cell2tally[i] = -1;
+}
+
 /* ---------------------------------------------------------------------- */
 
 void ComputeISurfGrid::grow_tally()
 {
   maxtally += DELTA;
   memory->grow(tally2surf,maxtally,"isurf/grid:tally2surf");
+  memory->grow(tally2cell,maxtally,"isurf/grid:tally2cell");
   memory->grow(array_surf_tally,maxtally,ntotal,"isurf/grid:array_surf_tally");
 }
 
 /* ----------------------------------------------------------------------
-   reset normflux for my surfs
+   reset normflux and cell2tally for my surfs and cells
    called whenever grid changes
 ------------------------------------------------------------------------- */
 
 void ComputeISurfGrid::reallocate()
 {
   init_normflux();
+  init_cell2tally();
 }
 
 /* ----------------------------------------------------------------------
@@ -533,5 +563,7 @@ bigint ComputeISurfGrid::memory_usage()
   bytes += ntotal*maxgrid * sizeof(double);     // array_grid
   bytes += ntotal*maxtally * sizeof(double);    // array_surf_tally
   bytes += maxtally * sizeof(surfint);          // tally2surf
+  bytes += maxtally * sizeof(int);              // tally2cell
+  bytes += ncell2tally * sizeof(int);           // cell2tally
   return bytes;
 }
@@ -24,7 +24,6 @@ ComputeStyle(isurf/grid,ComputeISurfGrid)
 #include "compute.h"
 #include "grid.h"
 #include "surf.h"
-#include "hash3.h"
 
 namespace SPARTA_NS {
 
@@ -48,23 +47,20 @@ class ComputeISurfGrid : public Compute {
   double nfactor_inverse;
   int *which;
 
-  int ntally;              // # of surfs I have tallied for
+  int ntally;              // # of cells I have tallied for
   int maxtally;            // # of tallies currently allocated
   surfint *tally2surf;     // tally2surf[I] = surf ID of Ith tally
 
-  // hash for surf IDs
+  // direct index from local grid cells to tallies, avoids a hash lookup per hit
+  // implicit surfs are tallied by cell, so all surfs in a cell share one tally
 
-#ifdef SPARTA_MAP
-  typedef std::map<surfint,int> MyHash;
-#elif defined SPARTA_UNORDERED_MAP
-  typedef std::unordered_map<surfint,int> MyHash;
-#else
-  typedef std::tr1::unordered_map<surfint,int> MyHash;
-#endif
-
-  MyHash *hash;
+  int ncell2tally;         // length of cell2tally = nlocal + nghost cells
+  int *cell2tally;         // cell2tally[I] = tally index of Ith cell, -1 if none
+  int *tally2cell;         // tally2cell[I] = local cell index of Ith tally
 
   int dim;                 // local copies
+  Grid::ChildCell *cells;
+  Grid::SplitInfo *sinfo;
   Grid::ChildInfo *cinfo;
   Surf::Line *lines;
   Surf::Tri *tris;
@@ -75,6 +71,7 @@ class ComputeISurfGrid : public Compute {
 
   void init_normflux();
   void grow_tally();
+  void init_cell2tally();
 };
 
 }
@@ -103,13 +103,14 @@ ComputeReactISurfGrid(SPARTA *sparta, int narg, char **arg) :
   ntally = maxtally = 0;
   array_surf_tally = NULL;
   tally2surf = NULL;
+  ncell2tally = 0;
+  cell2tally = NULL;
+  tally2cell = NULL;
 
   maxgrid = 0;
   array_grid = NULL;
   combined = 0;
 
-  hash = new MyHash;
-
   dim = domain->dimension;
 }
 
@@ -120,8 +121,9 @@ ComputeReactISurfGrid::~ComputeReactISurfGrid()
   memory->destroy(reaction2col);
   memory->destroy(array_surf_tally);
   memory->destroy(tally2surf);
+  memory->destroy(cell2tally);
+  memory->destroy(tally2cell);
   memory->destroy(array_grid);
-  delete hash;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -134,6 +136,10 @@ void ComputeReactISurfGrid::init()
   if (!surf->implicit) 
     error->all(FLERR,"Cannot use compute react/isurf/grid with explicit surfs");
 
+  // set cell2tally for all owned + ghost cells
+
+  init_cell2tally();
+
   // warn if any surfs in group are assigned to different surf react model
 
   lines = surf->lines;
@@ -189,11 +195,15 @@ void ComputeReactISurfGrid::clear()
 {
   lines = surf->lines;
   tris = surf->tris;
+  cells = grid->cells;
+  sinfo = grid->sinfo;
 
-  // clear hash of tallied surf IDs
+  // reset cell2tally for cells tallied since last clear
+  // skip stale indices if cell2tally was re-initialized since then
   // called by Update at beginning of timesteps surf tallying is done
 
-  hash->clear();
+  for (int i = 0; i < ntally; i++)
+    if (tally2cell[i] < ncell2tally) cell2tally[tally2cell[i]] = -1;
   ntally = 0;
   combined = 0;
 }
@@ -230,8 +240,8 @@ void ComputeReactISurfGrid::surf_tally(int isurf, int icell, int reaction,
     if (tris[isurf].isr != isr) return;
   }
 
-  // itally = tally index of isurf
-  // if 1st reaction on this isurf, add surf ID to hash
+  // itally = tally index of the grid cell containing isurf
+  // if 1st reaction on a surf in the cell, assign it next tally index
   // grow tally list if needed
   // for implicit surfs, surfID is really a cellID
 
@@ -242,12 +252,19 @@ void ComputeReactISurfGrid::surf_tally(int isurf, int icell, int reaction,
   if (dim == 2) surfID = lines[isurf].id;
   else surfID = tris[isurf].id;
 
-  if (hash->find(surfID) != hash->end()) itally = (*hash)[surfID];
-  else {
+  // implicit surfs in a sub cell are tallied by their split cell
+
+  int jcell = icell;
+  if (jcell < grid->nlocal && cells[jcell].nsplit <= 0)
+    jcell = sinfo[cells[jcell].isplit].icell;
+
+  itally = cell2tally[jcell];
+  if (itally < 0) {
     if (ntally == maxtally) grow_tally();
     itally = ntally;
-    (*hash)[surfID] = itally;
+    cell2tally[jcell] = itally;
     tally2surf[itally] = surfID;
+    tally2cell[itally] = jcell;
     vec = array_surf_tally[itally];
     for (int i = 0; i < ntotal; i++) vec[i] = 0.0;
     ntally++;
@@ -341,15 +358,40 @@ void ComputeReactISurfGrid::post_process_isurf_grid()
   }
 }
 
+/* ----------------------------------------------------------------------
+   reset cell2tally to -1 for all owned + ghost grid cells
+   called by init before each run and whenever grid changes,
+     since local indices of cells may then have changed
+------------------------------------------------------------------------- */
+
+void ComputeReactISurfGrid::init_cell2tally()
+{
+  ncell2tally = grid->nlocal + grid->nghost;
+  memory->destroy(cell2tally);
+  memory->create(cell2tally,ncell2tally,"isurf/grid:cell2tally");
+  for (int i = 0; i < ncell2tally; i++) cell2tally[i] = -1;
+}
+
 /* ---------------------------------------------------------------------- */
 
 void ComputeReactISurfGrid::grow_tally()
 {
   maxtally += DELTA;
   memory->grow(tally2surf,maxtally,"isurf/grid:tally2surf");
+  memory->grow(tally2cell,maxtally,"isurf/grid:tally2cell");
   memory->grow(array_surf_tally,maxtally,ntotal,"isurf/grid:array_surf_tally");
 }
 
+/* ----------------------------------------------------------------------
+   reset cell2tally for my cells
+   called whenever grid changes
+------------------------------------------------------------------------- */
+
+void ComputeReactISurfGrid::reallocate()
+{
+  init_cell2tally();
+}
+
 /* ----------------------------------------------------------------------
    memory usage
 ------------------------------------------------------------------------- */
@@ -360,5 +402,7 @@ bigint ComputeReactISurfGrid::memory_usage()
   bytes += ntotal*maxgrid * sizeof(double);     // array_grid
   bytes += ntotal*maxtally * sizeof(double);    // array_surf_tally
   bytes += maxtally * sizeof(surfint);          // tally2surf
+  bytes += maxtally * sizeof(int);              // tally2cell
+  bytes += ncell2tally * sizeof(int);           // cell2tally
   return bytes;
 }
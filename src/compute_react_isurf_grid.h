@@ -24,7 +24,6 @@ ComputeStyle(react/isurf/grid,ComputeReactISurfGrid)
 #include "compute.h"
 #include "grid.h"
 #include "surf.h"
-#include "hash3.h"
 
 namespace SPARTA_NS {
 
@@ -39,6 +38,7 @@ class ComputeReactISurfGrid : public Compute {
                           Particle::OnePart *, Particle::OnePart *);
   virtual int tallyinfo(surfint *&);
   void post_process_isurf_grid();
+  void reallocate();
   bigint memory_usage();
 
  protected:
@@ -49,27 +49,25 @@ class ComputeReactISurfGrid : public Compute {
 
   int **reaction2col;      // 1 if ireaction triggers tally for icol
 
-  int ntally;              // # of surfs I have tallied for
+  int ntally;              // # of cells I have tallied for
   int maxtally;            // # of tallies currently allocated
   surfint *tally2surf;     // tally2surf[I] = surf ID of Ith tally
 
-  // hash for surf IDs
+  // direct index from local grid cells to tallies, avoids a hash lookup per hit
+  // implicit surfs are tallied by cell, so all surfs in a cell share one tally
 
-#ifdef SPARTA_MAP
-  typedef std::map<surfint,int> MyHash;
-#elif defined SPARTA_UNORDERED_MAP
-  typedef std::unordered_map<surfint,int> MyHash;
-#else
-  typedef std::tr1::unordered_map<surfint,int> MyHash;
-#endif
-
-  MyHash *hash;
+  int ncell2tally;         // length of cell2tally = nlocal + nghost cells
+  int *cell2tally;         // cell2tally[I] = tally index of Ith cell, -1 if none
+  int *tally2cell;         // tally2cell[I] = local cell index of Ith tally
 
   int dim;                 // local copies
+  Grid::ChildCell *cells;
+  Grid::SplitInfo *sinfo;
   Surf::Line *lines;
   Surf::Tri *tris;
 
   void grow_tally();
+  void init_cell2tally();
 };
 
 }
@@ -94,13 +94,14 @@ ComputeReactSurf::ComputeReactSurf(SPARTA *sparta, int narg, char **arg) :
   ntally = maxtally = 0;
   array_surf_tally = NULL;
   tally2surf = NULL;
+  nsurf2tally = 0;
+  surf2tally = NULL;
+  tally2index = NULL;
 
   maxsurf = 0;
   array_surf = NULL;
   combined = 0;
 
-  hash = new MyHash;
-
   dim = domain->dimension;
 }
 
@@ -111,8 +112,9 @@ ComputeReactSurf::~ComputeReactSurf()
   memory->destroy(reaction2col);
   memory->destroy(array_surf_tally);
   memory->destroy(tally2surf);
+  memory->destroy(surf2tally);
+  memory->destroy(tally2index);
   memory->destroy(array_surf);
-  delete hash;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -124,6 +126,10 @@ void ComputeReactSurf::init()
   if (surf->implicit) 
     error->all(FLERR,"Cannot use compute react/surf with implicit surfs");
 
+  // set surf2tally for all owned + ghost surfs
+
+  init_surf2tally();
+
   // warn if any surfs in group are assigned to different surf react model
 
   lines = surf->lines;
@@ -181,10 +187,12 @@ void ComputeReactSurf::clear()
   lines = surf->lines;
   tris = surf->tris;
 
-  // clear hash of tallied surf IDs
+  // reset surf2tally for surfs tallied since last clear
+  // skip stale indices if surf2tally was re-initialized since then
   // called by Update at beginning of timesteps surf tallying is done
 
-  hash->clear();
+  for (int i = 0; i < ntally; i++)
+    if (tally2index[i] < nsurf2tally) surf2tally[tally2index[i]] = -1;
   ntally = 0;
   combined = 0;
 }
@@ -220,7 +228,7 @@ void ComputeReactSurf::surf_tally(int isurf, int icell, int reaction,
   }
 
   // itally = tally index of isurf
-  // if 1st reaction on this isurf, add surf ID to hash
+  // if 1st reaction on this isurf, assign it next tally index
   // grow tally list if needed
 
   int itally;
@@ -230,12 +238,13 @@ void ComputeReactSurf::surf_tally(int isurf, int icell, int reaction,
   if (dim == 2) surfID = lines[isurf].id;
   else surfID = tris[isurf].id;
 
-  if (hash->find(surfID) != hash->end()) itally = (*hash)[surfID];
-  else {
+  itally = surf2tally[isurf];
+  if (itally < 0) {
     if (ntally == maxtally) grow_tally();
     itally = ntally;
-    (*hash)[surfID] = itally;
+    surf2tally[isurf] = itally;
     tally2surf[itally] = surfID;
+    tally2index[itally] = isurf;
     vec = array_surf_tally[itally];
     for (int i = 0; i < ntotal; i++) vec[i] = 0.0;
     ntally++;
@@ -296,15 +305,41 @@ void ComputeReactSurf::post_process_surf()
 }
 
 
+/* ----------------------------------------------------------------------
+   reset surf2tally to -1 for all surfs I store
+   distributed: nlocal + nghost
+   called by init before each run and whenever grid changes,
+     since local indices of surfs may then have changed
+------------------------------------------------------------------------- */
+
+void ComputeReactSurf::init_surf2tally()
+{
+  nsurf2tally = surf->nlocal + surf->nghost;
+  memory->destroy(surf2tally);
+  memory->create(surf2tally,nsurf2tally,"react/surf:surf2tally");
+  for (int i = 0; i < nsurf2tally; i++) surf2tally[i] = -1;
+}
+
 /* ---------------------------------------------------------------------- */
 
 void ComputeReactSurf::grow_tally()
 {
   maxtally += DELTA;
   memory->grow(tally2surf,maxtally,"react/surf:tally2surf");
+  memory->grow(tally2index,maxtally,"react/surf:tally2index");
   memory->grow(array_surf_tally,maxtally,ntotal,"react/surf:array_surf_tally");
 }
 
+/* ----------------------------------------------------------------------
+   reset surf2tally for my surfs
+   called whenever grid changes
+------------------------------------------------------------------------- */
+
+void ComputeReactSurf::reallocate()
+{
+  init_surf2tally();
+}
+
 /* ----------------------------------------------------------------------
    memory usage
 ------------------------------------------------------------------------- */
@@ -314,5 +349,7 @@ bigint ComputeReactSurf::memory_usage()
   bigint bytes = 0;
   bytes += ntotal*maxtally * sizeof(double);    // array_surf_tally
   bytes += maxtally * sizeof(surfint);          // tally2surf
+  bytes += maxtally * sizeof(int);              // tally2index
+  bytes += nsurf2tally * sizeof(int);           // surf2tally
   return bytes;
 }
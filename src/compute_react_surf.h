@@ -23,7 +23,6 @@ ComputeStyle(react/surf,ComputeReactSurf)
 
 #include "compute.h"
 #include "surf.h"
-#include "hash3.h"
 
 namespace SPARTA_NS {
 
@@ -38,6 +37,7 @@ class ComputeReactSurf : public Compute {
                           Particle::OnePart *, Particle::OnePart *);
   virtual int tallyinfo(surfint *&);
   virtual void post_process_surf();
+  void reallocate();
   bigint memory_usage();
 
  protected:
@@ -52,23 +52,18 @@ class ComputeReactSurf : public Compute {
   int maxtally;            // # of tallies currently allocated
   surfint *tally2surf;     // tally2surf[I] = surf ID of Ith tally
 
-  // hash for surf IDs
+  // direct index from local surfs to tallies, avoids a hash lookup per hit
 
-#ifdef SPARTA_MAP
-  typedef std::map<surfint,int> MyHash;
-#elif defined SPARTA_UNORDERED_MAP
-  typedef std::unordered_map<surfint,int> MyHash;
-#else
-  typedef std::tr1::unordered_map<surfint,int> MyHash;
-#endif
-
-  MyHash *hash;
+  int nsurf2tally;         // length of surf2tally = nlocal + nghost surfs
+  int *surf2tally;         // surf2tally[I] = tally index of Ith surf, -1 if none
+  int *tally2index;        // tally2index[I] = local surf index of Ith tally
 
   int dim;                 // local copies
   Surf::Line *lines;
   Surf::Tri *tris;
 
   void grow_tally();
+  void init_surf2tally();
 };
 
 }
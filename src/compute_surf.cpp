@@ -85,14 +85,15 @@ ComputeSurf::ComputeSurf(SPARTA *sparta, int narg, char **arg) :
   ntally = maxtally = 0;
   array_surf_tally = NULL;
   tally2surf = NULL;
+  nsurf2tally = 0;
+  surf2tally = NULL;
+  tally2index = NULL;
 
   maxsurf = 0;
   array_surf = NULL;
   normflux = NULL;
   combined = 0;
 
-  hash = new MyHash;
-
   dim = domain->dimension;
 }
 
@@ -105,9 +106,10 @@ ComputeSurf::~ComputeSurf()
   delete [] which;
   memory->destroy(array_surf_tally);
   memory->destroy(tally2surf);
+  memory->destroy(surf2tally);
+  memory->destroy(tally2index);
   memory->destroy(array_surf);
   memory->destroy(normflux);
-  delete hash;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -122,9 +124,10 @@ void ComputeSurf::init()
   if (ngroup != particle->mixture[imix]->ngroup)
     error->all(FLERR,"Number of groups in compute surf mixture has changed");
 
-  // set normflux for all owned + ghost surfs
+  // set normflux and surf2tally for all owned + ghost surfs
 
   init_normflux();
+  init_surf2tally();
 
   // set weightflag if cell weighting is enabled
   // else weight = 1.0 for all particles
@@ -194,10 +197,12 @@ void ComputeSurf::clear()
   lines = surf->lines;
   tris = surf->tris;
 
-  // clear hash of tallied surf IDs
+  // reset surf2tally for surfs tallied since last clear
+  // skip stale indices if surf2tally was re-initialized since then
   // called by Update at beginning of timesteps surf tallying is done
 
-  hash->clear();
+  for (int i = 0; i < ntally; i++)
+    if (tally2index[i] < nsurf2tally) surf2tally[tally2index[i]] = -1;
   ntally = 0;
   combined = 0;
 }
@@ -231,7 +236,7 @@ void ComputeSurf::surf_tally(int isurf, int icell, int reaction,
   if (igroup < 0) return;
 
   // itally = tally index of isurf
-  // if 1st particle hitting isurf, add surf ID to hash
+  // if 1st particle hitting isurf, assign it next tally index
   // grow tally list if needed
 
   int itally,transparent;
@@ -246,12 +251,13 @@ void ComputeSurf::surf_tally(int isurf, int icell, int reaction,
     transparent = tris[isurf].transparent;
   }
 
-  if (hash->find(surfID) != hash->end()) itally = (*hash)[surfID];
-  else {
+  itally = surf2tally[isurf];
+  if (itally < 0) {
     if (ntally == maxtally) grow_tally();
     itally = ntally;
-    (*hash)[surfID] = itally;
+    surf2tally[isurf] = itally;
     tally2surf[itally] = surfID;
+    tally2index[itally] = isurf;
     vec = array_surf_tally[itally];
     for (int i = 0; i < ntotal; i++) vec[i] = 0.0;
     ntally++;
@@ -503,23 +509,40 @@ void ComputeSurf::post_process_surf()
 }
 
 
+/* ----------------------------------------------------------------------
+   reset surf2tally to -1 for all surfs I store
+   distributed: nlocal + nghost
+   called by init before each run and whenever grid changes,
+     since local indices of surfs may then have changed
+------------------------------------------------------------------------- */
+
+void ComputeSurf::init_surf2tally()
+{
+  nsurf2tally = surf->nlocal + surf->nghost;
+  memory->destroy(surf2tally);
+  memory->create(surf2tally,nsurf2tally,"surf:surf2tally");
+  for (int i = 0; i < nsurf2tally; i++) surf2tally[i] = -1;
+}
+
 /* ---------------------------------------------------------------------- */
 
 void ComputeSurf::grow_tally()
 {
   maxtally += DELTA;
   memory->grow(tally2surf,maxtally,"surf:tally2surf");
+  memory->grow(tally2index,maxtally,"surf:tally2index");
   memory->grow(array_surf_tally,maxtally,ntotal,"surf:array_surf_tally");
 }
 
 /* ----------------------------------------------------------------------
-   reset normflux for my surfs
+   reset normflux and surf2tally for my surfs
    called whenever grid changes
 ------------------------------------------------------------------------- */
 
 void ComputeSurf::reallocate()
 {
   init_normflux();
+  init_surf2tally();
 }
 
 /* ----------------------------------------------------------------------
@@ -531,5 +554,7 @@ bigint ComputeSurf::memory_usage()
   bigint bytes = 0;
   bytes += ntotal*maxtally * sizeof(double);    // array_surf_tally
   bytes += maxtally * sizeof(surfint);          // tally2surf
+  bytes += maxtally * sizeof(int);              // tally2index
+  bytes += nsurf2tally * sizeof(int);           // surf2tally
   return bytes;
 }
@@ -445,6 +445,7 @@ void CreateParticles::create_single()
    only insert in cells uncut by surfs
    account for cell weighting
    attributes of created particle depend on number of procs
+     unless global rng philox is used, then only per-cell counts do
 ------------------------------------------------------------------------- */
 
 void CreateParticles::create_local(bigint np)
@@ -456,6 +457,12 @@ void CreateParticles::create_local(bigint np)
   double seed = update->ranmaster->uniform();
   random->reset(seed,me,100);
 
+  // counter-based RNG streams are keyed by a seed from the master RNG,
+  //   which is the same on all procs, and re-selected for each cell
+
+  int rng_counter = update->rng_counter;
+  if (rng_counter) random->counter(update->ranmaster->uniform());
+
   Grid::ChildCell *cells = grid->cells;
   Grid::ChildInfo *cinfo = grid->cinfo;
   int nglocal = grid->nlocal;
@@ -556,6 +563,7 @@ void CreateParticles::create_local(bigint np)
     else volone = (hi[0]-lo[0]) * (hi[1]-lo[1]);
     volsum += volone / cinfo[i].weight;
 
+    if (rng_counter) random->stream(update->ntimestep,cells[i].id,0);
     ntarget = nme * volsum/volme - nprev;
     npercell = static_cast<int> (ntarget);
     if (random->uniform() < ntarget-npercell) npercell++;
@@ -634,6 +642,7 @@ void CreateParticles::create_local(bigint np)
    only insert in cells uncut by surfs
    account for cell weighting
    attributes of created particle depend on number of procs
+     unless global rng philox is used, then only per-cell counts do
 ------------------------------------------------------------------------- */
 
 void CreateParticles::create_local_twopass(bigint np)
@@ -645,6 +654,12 @@ void CreateParticles::create_local_twopass(bigint np)
   double seed = update->ranmaster->uniform();
   random->reset(seed,me,100);
 
+  // counter-based RNG streams are keyed by a seed from the master RNG,
+  //   which is the same on all procs, and re-selected for each cell
+
+  int rng_counter = update->rng_counter;
+  if (rng_counter) random->counter(update->ranmaster->uniform());
+
   Grid::ChildCell *cells = grid->cells;
   Grid::ChildInfo *cinfo = grid->cinfo;
   int nglocal = grid->nlocal;
@@ -747,6 +762,7 @@ void CreateParticles::create_local_twopass(bigint np)
     else volone = (hi[0]-lo[0]) * (hi[1]-lo[1]);
     volsum += volone / cinfo[i].weight;
 
+    if (rng_counter) random->stream(update->ntimestep,cells[i].id,0);
     ntarget = nme * volsum/volme - nprev;
     npercell = static_cast<int> (ntarget);
     if (random->uniform() < ntarget-npercell) npercell++;
@@ -774,6 +790,7 @@ void CreateParticles::create_local_twopass(bigint np)
     if (region && region->bboxflag && outside_region(dimension,lo,hi))
       continue;
     ncreate = ncreate_values[i];
+    if (rng_counter) random->stream(update->ntimestep,cells[i].id,1);
 
     for (int m = 0; m < ncreate; m++) {
       rn = random->uniform();
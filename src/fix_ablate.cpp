@@ -16,6 +16,7 @@
 #include "stdlib.h"
 #include "string.h"
 #include "fix_ablate.h"
+#include "input.h"
 #include "update.h"
 #include "grid.h"
 #include "domain.h"
@@ -106,12 +107,30 @@ FixAblate::FixAblate(SPARTA *sparta, int narg, char **arg) :
     delete [] suffix;
 
   } else if (strcmp(arg[5],"random") == 0) {
-    if (narg != 7) error->all(FLERR,"Illegal fix ablate command");
+    if (narg < 7) error->all(FLERR,"Illegal fix ablate command");
     which = RANDOM;
-    maxrandom = atoi(arg[6]);
+    maxrandom = input->inumeric(FLERR,arg[6]);
+    if (maxrandom <= 0) error->all(FLERR,"Illegal fix ablate command");
 
   } else error->all(FLERR,"Illegal fix ablate command");
 
+  // optional args, any other args are an error
+
+  incremental = 0;
+
+  int iarg = 6;
+  if (which == RANDOM) iarg = 7;
+
+  while (iarg < narg) {
+    if (strcmp(arg[iarg],"incremental") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal fix ablate command");
+      if (strcmp(arg[iarg+1],"yes") == 0) incremental = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) incremental = 0;
+      else error->all(FLERR,"Illegal fix ablate command");
+      iarg += 2;
+    } else error->all(FLERR,"Illegal fix ablate command");
+  }
+
   // error check
 
   if (which == COMPUTE) {
@@ -200,6 +219,12 @@ FixAblate::FixAblate(SPARTA *sparta, int narg, char **arg) :
   // uncomment two lines if want to change that
   // b/c set_delta_random() is decrementing the same no matter who owns a cell
 
+  // incremental mode caches cut/split results of each grid cell
+  // so only cells whose implicit surfs change are re-cut and re-split
+  // marching squares/cubes, ghosts, and set_inout() still see all cells
+
+  if (incremental) grid->split_cache(1);
+
   random = NULL;
   if (which == RANDOM) {
     random = new RanPark(update->ranmaster->uniform());
@@ -242,6 +267,8 @@ FixAblate::~FixAblate()
   delete mc;
 
   delete random;
+
+  if (incremental) grid->split_cache(0);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -583,6 +610,11 @@ void FixAblate::create_surfs(int outflag)
   int icell,splitcell,subcell,flag;
   double *x;
 
+  // if incremental, skip particles in cells whose surfs did not change,
+  //   since they were already outside those surfs
+
+  int *splitreuse = grid->splitreuse;
+
   ncount = 0;
   for (int i = 0; i < pnlocal; i++) {
     particles[i].flag = PKEEP;
@@ -590,10 +622,13 @@ void FixAblate::create_surfs(int outflag)
     if (cells[icell].nsurf == 0) continue;
 
     int mcell = icell;
+    if (cells[icell].nsplit <= 0) mcell = sinfo[cells[icell].isplit].icell;
+    if (incremental && splitreuse[mcell]) continue;
+
     x = particles[i].x;
     flag = 1;
     if (cells[icell].nsplit <= 0) {
-      mcell = splitcell = sinfo[cells[icell].isplit].icell;
+      splitcell = mcell;
       flag = grid->outside_surfs(splitcell,x,cut3d,cut2d);
     } else flag = grid->outside_surfs(icell,x,cut3d,cut2d);
     
@@ -648,6 +683,7 @@ void FixAblate::create_surfs(int outflag)
 
   particle->nlocal = pnlocal;
   particle->sorted = 0;
+  particle->incremental = 0;
 }
 
 /* ----------------------------------------------------------------------
@@ -62,6 +62,7 @@ class FixAblate : public Fix {
   double thresh;
   double sum_delta;
   int ndelete;
+  int incremental;        // 1 to only re-cut cells whose surfs changed
    
   int nglocal;            // # of owned grid cells
 
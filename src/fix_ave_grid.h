@@ -92,7 +92,7 @@ class FixAveGrid : public Fix {
 #elif defined SPARTA_UNORDERED_MAP
   typedef std::unordered_map<cellint,int> MyHash;
 #else
-  typedef std::tr1::unordered_map<cellint,int> MyHash;
+  typedef FlatHash<cellint> MyHash;
 #endif
 
   MyHash *hash;
@@ -22,6 +22,7 @@
 #include "domain.h"
 #include "comm.h"
 #include "rcb.h"
+#include "sfc.h"
 #include "modify.h"
 #include "compute.h"
 #include "output.h"
@@ -34,7 +35,7 @@
 
 using namespace SPARTA_NS;
 
-enum{RANDOM,PROC,BISECTION};
+enum{RANDOM,PROC,BISECTION,CURVE};
 enum{CELL,PARTICLE,TIME};
 
 #define ZEROPARTICLE 0.1
@@ -71,12 +72,21 @@ FixBalance::FixBalance(SPARTA *sparta, int narg, char **arg) :
     else if (strcmp(arg[5],"time") == 0) rcbwt = TIME;
     else error->all(FLERR,"Illegal fix balance command");
     iarg = 6;
+  } else if (strcmp(arg[4],"sfc") == 0) {
+    if (narg < 6) error->all(FLERR,"Illegal fix balance command");
+    bstyle = CURVE;
+    if (strcmp(arg[5],"cell") == 0) rcbwt = CELL;
+    else if (strcmp(arg[5],"part") == 0) rcbwt = PARTICLE;
+    else if (strcmp(arg[5],"time") == 0) rcbwt = TIME;
+    else error->all(FLERR,"Illegal fix balance command");
+    iarg = 6;
   } else error->all(FLERR,"Illegal fix balance command");
 
   // optional args
 
   strcpy(eligible,"xyz");
   rcbflip = 0;
+  fraction = 0.0;
 
   while (iarg < narg) {
     if (strcmp(arg[iarg],"axes") == 0) {
@@ -101,6 +111,12 @@ FixBalance::FixBalance(SPARTA *sparta, int narg, char **arg) :
       else if (strcmp(arg[iarg+1],"no") == 0) rcbflip = 0;
       else error->all(FLERR,"Illegal fix balance command");
       iarg += 2;
+    } else if (strcmp(arg[iarg],"incremental") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal fix balance command");
+      fraction = atof(arg[iarg+1]);
+      if (fraction <= 0.0 || fraction > 1.0)
+        error->all(FLERR,"Illegal fix balance command");
+      iarg += 2;
     } else error->all(FLERR,"Illegal fix balance command");
   }
 
@@ -108,18 +124,22 @@ FixBalance::FixBalance(SPARTA *sparta, int narg, char **arg) :
 
   if (nevery < 0 || thresh < 1.0)
     error->all(FLERR,"Illegal fix balance command");
+  if (fraction > 0.0 && bstyle != CURVE)
+    error->all(FLERR,"Fix balance incremental requires sfc style");
 
   me = comm->me;
   nprocs = comm->nprocs;
 
-  // create instance of RNG or RCB
+  // create instance of RNG or RCB or SFC
 
   random = NULL;
   rcb = NULL;
+  sfc = NULL;
 
   if (bstyle == RANDOM || bstyle == PROC) 
     random = new RanPark(update->ranmaster->uniform()); 
   if (bstyle == BISECTION) rcb = new RCB(sparta);
+  if (bstyle == CURVE) sfc = new SFC(sparta);
 
   // compute initial outputs
 
@@ -133,6 +153,7 @@ FixBalance::~FixBalance()
 {
   delete random;
   delete rcb;
+  delete sfc;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -150,8 +171,9 @@ void FixBalance::init()
 {
   // error b/c acquire_ghosts() is a no-op in this case
 
-  if (bstyle != BISECTION && grid->cutoff >= 0.0)
-    error->all(FLERR,"Cannot use non-rcb fix balance with a grid cutoff");
+  if (bstyle != BISECTION && bstyle != CURVE && grid->cutoff >= 0.0)
+    error->all(FLERR,
+               "Fix balance with a grid cutoff requires rcb or sfc style");
 
   last = 0.0;
   timer->init();
@@ -200,7 +222,7 @@ void FixBalance::end_of_step()
       if (newproc == nprocs) newproc = 0;
     }
 
-  } else if (bstyle == BISECTION) {
+  } else if (bstyle == BISECTION || bstyle == CURVE) {
     double **x;
     memory->create(x,nglocal,3,"balance:x");
 
@@ -234,22 +256,30 @@ void FixBalance::end_of_step()
       timer_cell_weights(wt);
     }
 
-    rcb->compute(nbalance,x,wt,eligible,rcbflip);
-    rcb->invert();
+    int *sendproc;
+    if (bstyle == BISECTION) {
+      rcb->compute(nbalance,x,wt,eligible,rcbflip);
+      rcb->invert();
+      sendproc = rcb->sendproc;
+      nmigrate = nbalance - rcb->nkeep;
+    } else {
+      if (fraction > 0.0) sfc->diffuse(nbalance,x,wt,fraction);
+      else sfc->compute(nbalance,x,wt);
+      sendproc = sfc->sendproc;
+      nmigrate = nbalance - sfc->nkeep;
+    }
 
     nbalance = 0;
-    int *sendproc = rcb->sendproc;
     for (int icell = 0; icell < nglocal; icell++) {
       if (cells[icell].nsplit <= 0) continue;
       cells[icell].proc = sendproc[nbalance++];
     }
-    nmigrate = nbalance - rcb->nkeep;
 
     memory->destroy(x);
     memory->destroy(wt);
   }
 
-  if (nprocs == 1 || bstyle == BISECTION) grid->clumped = 1;
+  if (nprocs == 1 || bstyle == BISECTION || bstyle == CURVE) grid->clumped = 1;
   else grid->clumped = 0;
 
   // sort particles
@@ -278,7 +308,7 @@ void FixBalance::end_of_step()
 
   // final imbalance factor
 
-  if (bstyle == BISECTION && rcbwt == TIME)
+  if ((bstyle == BISECTION || bstyle == CURVE) && rcbwt == TIME)
     imbfinal = 0.0; // can't compute imbalance from timers since grid cells moved
   else
     imbfinal = imbalance_factor(maxperproc);
@@ -295,7 +325,7 @@ double FixBalance::imbalance_factor(double &maxcost)
   double mycost,totalcost;
   double mycost_proc_weighted,maxcost_proc_weighted,nprocs_weighted;
 
-  if (bstyle == BISECTION && rcbwt == TIME) {
+  if ((bstyle == BISECTION || bstyle == CURVE) && rcbwt == TIME) {
     timer_cost();
     mycost = my_timer_cost;
   } else mycost = particle->nlocal;
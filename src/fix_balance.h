@@ -40,6 +40,7 @@ class FixBalance : public Fix {
   int me,nprocs;
   double thresh;
   int bstyle,rcbwt,rcbflip;
+  double fraction;              // max cut shift for incremental sfc, 0 if off
   char eligible[4];
   double last,my_timer_cost;
 
@@ -50,6 +51,7 @@ class FixBalance : public Fix {
 
   class RanPark *random;
   class RCB *rcb;
+  class SFC *sfc;
 
   double imbalance_factor(double &);
   void timer_cost();
@@ -69,7 +71,12 @@ Self-explanatory.  Check the input script syntax and compare to the
 documentation for the command.  You can use -echo screen as a
 command-line option when running SPARTA to see the offending line.
 
-E: Cannot use non-rcb fix balance with a grid cutoff
+E: Fix balance incremental requires sfc style
+
+Only the sfc style can shift its previous partitioning by a bounded
+amount.
+
+E: Fix balance with a grid cutoff requires rcb or sfc style
 
 This is because the load-balancing will generate a partitioning
 of cells to processors that is dispersed and which will not work
@@ -26,6 +26,7 @@
 #include "modify.h"
 #include "geometry.h"
 #include "input.h"
+#include "random_mars.h"
 #include "random_park.h"
 #include "math_const.h"
 #include "memory.h"
@@ -42,6 +43,7 @@ enum{NCHILD,NPARENT,NUNKNOWN,NPBCHILD,NPBPARENT,NPBUNKNOWN,NBOUND};  // Grid
 enum{NOSUBSONIC,PTBOTH,PONLY};
 
 #define DELTATASK 256
+#define NFACE 6
 #define TEMPLIMIT 1.0e5
 
 /* ---------------------------------------------------------------------- */
@@ -132,6 +134,12 @@ void FixEmitFace::init()
   
   FixEmit::init();
 
+  // counter-based RNG streams are keyed by a seed from the master RNG,
+  //   which is the same on all procs, and re-selected for each task
+
+  if (update->rng_counter) random->counter(update->ranmaster->uniform());
+  else random->counter(-1.0);
+
   // copies of class data before invoking parent init() and count_task()
 
   dimension = domain->dimension;
@@ -482,9 +490,16 @@ void FixEmitFace::perform_task_onepass()
   //   shift Maxwellian distribution by stream velocity component
   //   see Bird 1994, p 259, eq 12.5
 
+  // counter-based RNG stream is keyed by timestep, cell ID, and face
+  // so RNs do not depend on which proc owns the cell
+
   int nfix_add_particle = modify->n_add_particle;
+  Grid::ChildCell *cells = grid->cells;
+  int rng_counter = update->rng_counter;
 
   for (int i = 0; i < ntask; i++) {
+    if (rng_counter)
+      random->stream(update->ntimestep,cells[tasks[i].icell].id,tasks[i].iface);
     pcell = tasks[i].pcell;
     ndim = tasks[i].ndim;
     pdim = tasks[i].pdim;
@@ -659,7 +674,15 @@ void FixEmitFace::perform_task_twopass()
   int** ninsert_values;
   memory->create(ninsert_values, ntask, ninsert_dim1, "fix_emit_face:ninsert");
 
+  // counter-based RNG streams are keyed by timestep, cell ID, and face
+  // 2nd pass uses face+NFACE so its stream differs from the 1st pass
+
+  Grid::ChildCell *cells = grid->cells;
+  int rng_counter = update->rng_counter;
+
   for (int i = 0; i < ntask; i++) {
+    if (rng_counter)
+      random->stream(update->ntimestep,cells[tasks[i].icell].id,tasks[i].iface);
     if (perspecies) {
       for (isp = 0; isp < nspecies; isp++) {
         ntarget = tasks[i].ntargetsp[isp]+random->uniform();
@@ -679,6 +702,9 @@ void FixEmitFace::perform_task_twopass()
   }
 
   for (int i = 0; i < ntask; i++) {
+    if (rng_counter)
+      random->stream(update->ntimestep,cells[tasks[i].icell].id,
+                     tasks[i].iface+NFACE);
     pcell = tasks[i].pcell;
     ndim = tasks[i].ndim;
     pdim = tasks[i].pdim;
@@ -72,6 +72,11 @@ FixMoveSurf::FixMoveSurf(SPARTA *sparta, int narg, char **arg) :
 
   movesurf->process_args(narg-5,&arg[5]);
 
+  // local re-mapping of surfs to grid cells after each move
+  // cache split cell results so only changed cells are re-cut
+
+  if (movesurf->sweptflag) grid->split_cache(1);
+
   dim = domain->dimension;
   ntimestep_original = update->ntimestep;
 
@@ -101,6 +106,7 @@ FixMoveSurf::FixMoveSurf(SPARTA *sparta, int narg, char **arg) :
 
 FixMoveSurf::~FixMoveSurf()
 {
+  if (movesurf->sweptflag) grid->split_cache(0);
   delete movesurf;
   memory->sfree(origlines);
   memory->sfree(origtris);
@@ -161,11 +167,21 @@ void FixMoveSurf::end_of_step()
 	grid->combine_split_cell_particles(icell,1);
   }
 
-  grid->clear_surf();
+  // if local, only re-map surfs in cells overlapping swept bbox of moved surfs
+
+  if (movesurf->sweptflag)
+    grid->surf2grid_swept(movesurf->sweptlo,movesurf->swepthi,1,0);
+  else {
+    grid->clear_surf();
+    grid->surf2grid(1,0);
+  }
+
+  // split and sub cells were rebuilt, so particle cell lists must be too
 
-  grid->surf2grid(1,0);
+  particle->incremental = 0;
 
   // re-setup owned and ghost cell info
+  // done for all cells, even if sweptflag
 
   grid->setup_owned();
   grid->acquire_ghosts();
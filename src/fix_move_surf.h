@@ -61,7 +61,7 @@ Self-explanatory.  Check the input script syntax and compare to the
 documentation for the command.  You can use -echo screen as a
 command-line option when running SPARTA to see the offending line.
 
-E: Cannot use non-rcb fix balance with a grid cutoff
+E: Fix balance with a grid cutoff requires rcb or sfc style
 
 This is because the load-balancing will generate a partitioning
 of cells to processors that is dispersed and which will not work
@@ -0,0 +1,218 @@
+/* ----------------------------------------------------------------------
+   SPARTA - Stochastic PArallel Rarefied-gas Time-accurate Analyzer
+   http://sparta.sandia.gov
+   Steve Plimpton, sjplimp@sandia.gov, Michael Gallis, magalli@sandia.gov
+   Sandia National Laboratories
+
+   Copyright (2014) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level SPARTA directory.
+------------------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------------
+FlatHash = templated open-addressing hash from integer keys to int values
+  all entries are stored in one flat array, no per-entry mallocs
+  linear probing, deleted entries are back-shifted, so no tombstones
+  subset of std::map / std::unordered_map interface, so can be used
+    as a drop-in replacement for a MyHash typedef
+usage:
+  (*hash)[key] = value, find(key) == end(), erase(key), clear(), repeat
+  reserve(N) before a bulk insert of N keys avoids re-growing the table
+inputs:
+   template K = integer key type, e.g. cellint, surfint, bigint
+   key = -1 is reserved to flag empty slots, cannot be stored
+methods:
+   iterator find(key) = ptr to entry with first = key, second = value
+   int &operator[](key) = value for key, inserted as 0 if not present
+   int erase(key) = remove key, return 1 if it was present, else 0
+   void clear() = remove all keys, keep allocated table
+   void reserve(N) = grow table so N keys can be stored w/out re-growing
+   int size() = # of stored keys
+   bigint memory_usage() = size of table in bytes
+   begin(),end() = iterate over all entries, in no particular order
+------------------------------------------------------------------------- */
+
+#ifndef SPARTA_FLAT_HASH_H
+#define SPARTA_FLAT_HASH_H
+
+#include "stdlib.h"
+#include "stdint.h"
+#include "spatype.h"
+
+namespace SPARTA_NS {
+
+template<class K>
+class FlatHash {
+ public:
+  struct Entry {
+    K first;                     // key, -1 if slot is empty
+    int second;                  // value
+  };
+
+  class iterator {
+   public:
+    iterator() : ptr(NULL), stop(NULL) {}
+    iterator(Entry *p, Entry *s) : ptr(p), stop(s) {
+      while (ptr != stop && ptr->first == EMPTY) ptr++;
+    }
+    Entry &operator *() const { return *ptr; }
+    Entry *operator ->() const { return ptr; }
+    iterator &operator ++() {
+      ptr++;
+      while (ptr != stop && ptr->first == EMPTY) ptr++;
+      return *this;
+    }
+    bool operator ==(const iterator &other) const { return ptr == other.ptr; }
+    bool operator !=(const iterator &other) const { return ptr != other.ptr; }
+   private:
+    Entry *ptr,*stop;
+  };
+
+  FlatHash() {
+    table = NULL;
+    nslot = mask = nentry = 0;
+    allocate(MINSLOT);
+  }
+
+  ~FlatHash() { free(table); }
+
+  iterator begin() { return iterator(table,table+nslot); }
+  iterator end() { return iterator(table+nslot,table+nslot); }
+
+  // find slot with key by probing from its home slot til empty slot
+
+  iterator find(K key) {
+    if (key == EMPTY) return end();
+    int i = slot(key);
+    while (table[i].first != EMPTY) {
+      if (table[i].first == key) return iterator(&table[i],table+nslot);
+      i = (i+1) & mask;
+    }
+    return end();
+  }
+
+  int count(K key) { return find(key) != end(); }
+
+  // insert key with value 0 if not present
+  // grow table first so load factor stays <= MAXLOAD
+
+  int &operator [](K key) {
+    int i = slot(key);
+    while (table[i].first != EMPTY) {
+      if (table[i].first == key) return table[i].second;
+      i = (i+1) & mask;
+    }
+    if ((nentry+1) > MAXLOAD*nslot) {
+      grow(2*nslot);
+      i = slot(key);
+      while (table[i].first != EMPTY) i = (i+1) & mask;
+    }
+    table[i].first = key;
+    table[i].second = 0;
+    nentry++;
+    return table[i].second;
+  }
+
+  // remove key, then back-shift following entries of the same probe run
+  //   that can move closer to their home slot, so no tombstones needed
+
+  int erase(K key) {
+    if (key == EMPTY) return 0;
+    int i = slot(key);
+    while (table[i].first != key) {
+      if (table[i].first == EMPTY) return 0;
+      i = (i+1) & mask;
+    }
+
+    int j = i;
+    while (1) {
+      j = (j+1) & mask;
+      if (table[j].first == EMPTY) break;
+      int home = slot(table[j].first);
+      if (((j-home) & mask) >= ((j-i) & mask)) {
+        table[i] = table[j];
+        i = j;
+      }
+    }
+    table[i].first = EMPTY;
+    nentry--;
+    return 1;
+  }
+
+  void clear() {
+    if (nentry == 0) return;
+    for (int i = 0; i < nslot; i++) table[i].first = EMPTY;
+    nentry = 0;
+  }
+
+  void reserve(int n) {
+    int m = nslot;
+    while (n > MAXLOAD*m) m *= 2;
+    if (m > nslot) grow(m);
+  }
+
+  int size() const { return nentry; }
+  bool empty() const { return nentry == 0; }
+
+  bigint memory_usage() const { return (bigint) nslot * sizeof(Entry); }
+
+ private:
+  static const K EMPTY = -1;
+  static const int MINSLOT = 16;
+  static const double MAXLOAD;   // max fraction of filled slots
+
+  Entry *table;                  // nslot entries, power of 2
+  int nslot;                     // # of allocated slots
+  int mask;                      // nslot-1
+  int nentry;                    // # of filled slots
+
+  // home slot of key
+  // mix all bits of the key, since cell IDs differ mostly in high bits
+
+  int slot(K key) const {
+    uint64_t h = (uint64_t) key;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return (int) (h & mask);
+  }
+
+  void allocate(int n) {
+    table = (Entry *) malloc(n*sizeof(Entry));
+    nslot = n;
+    mask = n-1;
+    for (int i = 0; i < nslot; i++) table[i].first = EMPTY;
+  }
+
+  // re-insert all entries into a larger table
+
+  void grow(int n) {
+    Entry *old = table;
+    int nold = nslot;
+    allocate(n);
+
+    for (int k = 0; k < nold; k++) {
+      if (old[k].first == EMPTY) continue;
+      int i = slot(old[k].first);
+      while (table[i].first != EMPTY) i = (i+1) & mask;
+      table[i] = old[k];
+    }
+
+    free(old);
+  }
+
+  // not implemented, since class owns table
+
+  FlatHash(const FlatHash &);
+  FlatHash &operator=(const FlatHash &);
+};
+
+template<class K>
+const double FlatHash<K>::MAXLOAD = 0.75;
+
+}
+
+#endif
@@ -1032,6 +1032,143 @@ bool line_tri_intersect(double *start, double *stop,
   return true;
 }
 
+/* ----------------------------------------------------------------------
+   precompute data for line_tri_intersect() with a TriCache
+   v0,v1,v2 and norm = 3 vertices of triangle and unit normal vec
+   pvec = point - v0 = u*(v1-v0) + v*(v2-v0) + w*norm
+   a,b = rows of inverse of matrix with those 3 vectors as columns,
+     so u = a . pvec, v = b . pvec, via 1/det of the matrix
+   tolerance on u,v is EPSSQNEG scaled by 1/det,
+     same as tolerance on cross products in line_tri_intersect()
+------------------------------------------------------------------------- */
+
+void tri_cache(double *v0, double *v1, double *v2, double *norm, TriCache &c)
+{
+  double e1[3],e2[3],xproduct[3];
+
+  MathExtra::sub3(v1,v0,e1);
+  MathExtra::sub3(v2,v0,e2);
+  MathExtra::cross3(e1,e2,xproduct);
+  double det = MathExtra::dot3(xproduct,norm);
+  double invdet = 0.0;
+  if (det != 0.0) invdet = 1.0/det;
+
+  c.norm[0] = norm[0];
+  c.norm[1] = norm[1];
+  c.norm[2] = norm[2];
+  c.dnorm = MathExtra::dot3(norm,v0);
+
+  MathExtra::cross3(e2,norm,c.a);
+  MathExtra::scale3(invdet,c.a);
+  c.a0 = MathExtra::dot3(c.a,v0);
+
+  MathExtra::cross3(norm,e1,c.b);
+  MathExtra::scale3(invdet,c.b);
+  c.b0 = MathExtra::dot3(c.b,v0);
+
+  if (det != 0.0) c.eps = EPSSQNEG*invdet;
+  else c.eps = EPSSQNEG;
+  c.pad[0] = c.pad[1] = c.pad[2] = 0.0;
+}
+
+/* ----------------------------------------------------------------------
+   precompute data for line_line_intersect() with a LineCache
+   v0,v1 and norm = 2 vertices of line segment and unit normal vec
+   s = (point - v0) . edge / |edge|^2
+   tolerances on s are EPSSQ scaled by 1/|edge|^2,
+     same as tolerance on dot products in line_line_intersect()
+------------------------------------------------------------------------- */
+
+void line_cache(double *v0, double *v1, double *norm, LineCache &c)
+{
+  double edge[2];
+  edge[0] = v1[0] - v0[0];
+  edge[1] = v1[1] - v0[1];
+  double lensq = edge[0]*edge[0] + edge[1]*edge[1];
+  double invlensq = 0.0;
+  if (lensq > 0.0) invlensq = 1.0/lensq;
+
+  c.norm[0] = norm[0];
+  c.norm[1] = norm[1];
+  c.dnorm = norm[0]*v0[0] + norm[1]*v0[1];
+  c.t[0] = edge[0]*invlensq;
+  c.t[1] = edge[1]*invlensq;
+  c.t0 = c.t[0]*v0[0] + c.t[1]*v0[1];
+  c.epslo = EPSSQNEG*invlensq;
+  c.epshi = EPSSQ*invlensq;
+}
+
+/* ----------------------------------------------------------------------
+   same as line_tri_intersect() above, using precomputed TriCache
+   test is same up to round-off, with fewer flops and no access to tri pts
+   plane and inside tests are dot products with the cached vectors
+------------------------------------------------------------------------- */
+
+bool line_tri_intersect(double *start, double *stop, TriCache &c,
+			double *point, double &param, int &side)
+{
+  double dotstart = MathExtra::dot3(c.norm,start) - c.dnorm;
+  double dotstop = MathExtra::dot3(c.norm,stop) - c.dnorm;
+
+  if (dotstart < 0.0 && dotstop < 0.0) return false;
+  if (dotstart > 0.0 && dotstop > 0.0) return false;
+  if (dotstart == 0.0 && dotstop == 0.0) return false;
+
+  param = dotstart / (dotstart-dotstop);
+  param = MAX(param,0.0);
+  param = MIN(param,1.0);
+
+  point[0] = start[0] + param * (stop[0]-start[0]);
+  point[1] = start[1] + param * (stop[1]-start[1]);
+  point[2] = start[2] + param * (stop[2]-start[2]);
+
+  double u = MathExtra::dot3(c.a,point) - c.a0;
+  if (u < c.eps) return false;
+  double v = MathExtra::dot3(c.b,point) - c.b0;
+  if (v < c.eps) return false;
+  if (1.0-u-v < c.eps) return false;
+
+  if (dotstart < 0.0) side = INSIDE;
+  else if (dotstart > 0.0) side = OUTSIDE;
+  else if (dotstop > 0.0) side = ONSURF2OUT;
+  else side = ONSURF2IN;
+
+  return true;
+}
+
+/* ----------------------------------------------------------------------
+   same as line_line_intersect() above, using precomputed LineCache
+------------------------------------------------------------------------- */
+
+bool line_line_intersect(double *start, double *stop, LineCache &c,
+			 double *point, double &param, int &side)
+{
+  double dotstart = c.norm[0]*start[0] + c.norm[1]*start[1] - c.dnorm;
+  double dotstop = c.norm[0]*stop[0] + c.norm[1]*stop[1] - c.dnorm;
+
+  if (dotstart < 0.0 && dotstop < 0.0) return false;
+  if (dotstart > 0.0 && dotstop > 0.0) return false;
+  if (dotstart == 0.0 && dotstop == 0.0) return false;
+
+  param = dotstart / (dotstart-dotstop);
+  if (param < 0.0 || param > 1.0) return false;
+
+  point[0] = start[0] + param * (stop[0]-start[0]);
+  point[1] = start[1] + param * (stop[1]-start[1]);
+  point[2] = 0.0;
+
+  double s = c.t[0]*point[0] + c.t[1]*point[1] - c.t0;
+  if (s < c.epslo) return false;
+  if (s > 1.0+c.epshi) return false;
+
+  if (dotstart < 0.0) side = INSIDE;
+  else if (dotstart > 0.0) side = OUTSIDE;
+  else if (dotstop > 0.0) side = ONSURF2OUT;
+  else side = ONSURF2IN;
+
+  return true;
+}
+
 /* ----------------------------------------------------------------------
    determine which side of plane the point x,y,z is on
    plane is defined by vertex pt v and unit normal vec
@@ -16,6 +16,25 @@
 #define SPARTA_GEOMETRY_H
 
 namespace Geometry {
+
+  // precomputed per-surf data for intersection tests of many
+  //   line segments with the same tri or line, see tri_cache(), line_cache()
+  // TriCache is 2 cache lines, LineCache is 1
+
+  struct TriCache {
+    double norm[3],dnorm;   // plane of tri is norm . x = dnorm
+    double a[3],a0;         // barycentric coord u = a . x - a0
+    double b[3],b0;         // barycentric coord v = b . x - b0
+    double eps;             // u,v,1-u-v must all be >= eps
+    double pad[3];
+  };
+
+  struct LineCache {
+    double norm[2],dnorm;   // line is norm . x = dnorm
+    double t[2],t0;         // fraction along line s = t . x - t0
+    double epslo,epshi;     // s must be >= epslo and <= 1+epshi
+  };
+
   int line_quad_intersect(double *, double *, double *,
 			  double *, double *);
   int quad_line_intersect_point(double *, double *, double *,
@@ -43,6 +62,13 @@ namespace Geometry {
   bool line_tri_intersect(double *, double *, 
 			  double *, double *, double *, double *,
 			  double *, double &param, int &);
+
+  void tri_cache(double *, double *, double *, double *, TriCache &);
+  void line_cache(double *, double *, double *, LineCache &);
+  bool line_tri_intersect(double *, double *, TriCache &,
+                          double *, double &param, int &);
+  bool line_line_intersect(double *, double *, LineCache &,
+                           double *, double &param, int &);
   int whichside(double *, double *, double, double, double);
   int point_on_hex(double *, double *, double *);
   int point_in_hex(double *, double *, double *);
@@ -18,6 +18,7 @@
 #include "domain.h"
 #include "region.h"
 #include "surf.h"
+#include "particle.h"
 #include "comm.h"
 #include "modify.h"
 #include "fix.h"
@@ -39,6 +40,8 @@ using namespace MathConst;
 #define LARGE 256000
 #define BIG 1.0e20
 #define MAXGROUP 32
+#define UCELLFACTOR 4
+#define UCELLEXTRA 1024
 
 // default values, can be overridden by global command
 
@@ -72,6 +75,7 @@ int corners[6][4] = {{0,2,4,6}, {1,3,5,7}, {0,1,4,5}, {2,3,6,7},
 Grid::Grid(SPARTA *sparta) : Pointers(sparta)
 {
   exist = exist_ghost = clumped = 0;
+  uniform = 0;
   MPI_Comm_rank(world,&me);
 
   gnames = (char **) memory->smalloc(MAXGROUP*sizeof(char *),"grid:gnames");
@@ -98,6 +102,7 @@ Grid::Grid(SPARTA *sparta) : Pointers(sparta)
   cinfo = NULL;
   sinfo = NULL;
   pcells = NULL;
+  pbox = NULL;
 
   maxbits = 8*sizeof(cellint)-1;
 
@@ -109,8 +114,34 @@ Grid::Grid(SPARTA *sparta) : Pointers(sparta)
 
   maxcellpersurf = MAXCELLPERSURF;
   cpsurf = NULL;
+  nthreads = 1;
+  tcut2d = NULL;
+  tcut3d = NULL;
   allocate_cell_arrays();
 
+  nhcell = maxhcell = 0;
+  hcells = NULL;
+  ucellflag = 0;
+  maxucell = 0;
+  ucell = NULL;
+
+  surfbin = 0;
+  pcompress = 0;
+
+  splitcacheflag = 0;
+  splitreuse = NULL;
+  maxsplitreuse = 0;
+  memset(&scprev,0,sizeof(SplitCacheList));
+  memset(&sccur,0,sizeof(SplitCacheList));
+  schash = NULL;
+  nsbincell = maxsbincell = maxsbin = 0;
+  maxsbinstart = maxsbinlist = maxsbinbox = 0;
+  sbincell = NULL;
+  sbins = NULL;
+  sbinstart = NULL;
+  sbinlist = NULL;
+  sbinbox = NULL;
+
   neighshift[XLO] = 0;
   neighshift[XHI] = 3;
   neighshift[YLO] = 6;
@@ -151,12 +182,23 @@ Grid::~Grid()
   memory->sfree(cinfo);
   memory->sfree(sinfo);
   memory->sfree(pcells);
+  memory->sfree(pbox);
 
   delete csurfs;
   delete csplits;
   delete csubs;
   delete cpsurf;
   delete hash;
+
+  memory->sfree(hcells);
+  memory->destroy(ucell);
+  splitcacheflag = 0;
+  split_cache(0);
+  memory->destroy(sbincell);
+  memory->sfree(sbins);
+  memory->destroy(sbinstart);
+  memory->destroy(sbinlist);
+  memory->destroy(sbinbox);
 }
 
 /* ----------------------------------------------------------------------
@@ -170,12 +212,13 @@ void Grid::remove()
   memory->sfree(cinfo);
   memory->sfree(sinfo);
   memory->sfree(pcells);
+  memory->sfree(pbox);
 
   delete csurfs;
   delete csplits;
   delete csubs;
 
-  exist_ghost = clumped = 0;
+  exist_ghost = clumped = uniform = 0;
   ncell = nunsplit = nsplit = nsub = 0;
   nlocal = nghost = maxlocal = maxcell = 0;
   nsplitlocal = nsplitghost = maxsplit = 0;
@@ -184,11 +227,15 @@ void Grid::remove()
 
   hash->clear();
   hashfilled = 0;
+  nhcell = 0;
+  ucellflag = 0;
+  nsbincell = 0;
 
   cells = NULL;
   cinfo = NULL;
   sinfo = NULL;
   pcells = NULL;
+  pbox = NULL;
 
   csurfs = NULL; csplits = NULL; csubs = NULL;
   allocate_surf_arrays();
@@ -286,12 +333,46 @@ void Grid::add_parent_cell(cellint id, int iparent,
   p->nx = nx;
   p->ny = ny;
   p->nz = nz;
-  p->lo[0] = lo[0]; p->lo[1] = lo[1]; p->lo[2] = lo[2]; 
-  p->hi[0] = hi[0]; p->hi[1] = hi[1]; p->hi[2] = hi[2]; 
+
+  if (pbox) {
+    ParentBox *b = &pbox[nparent];
+    b->lo[0] = lo[0]; b->lo[1] = lo[1]; b->lo[2] = lo[2]; 
+    b->hi[0] = hi[0]; b->hi[1] = hi[1]; b->hi[2] = hi[2]; 
+  }
 
   nparent++;
 }
 
+/* ----------------------------------------------------------------------
+   set pbox for parent cells from nstart to nparent-1
+   called after pcells were filled in bulk w/out add_parent_cell(),
+     e.g. gathered from other procs or read from restart file
+   assumes each parent cell is stored after its own parent, as they are
+------------------------------------------------------------------------- */
+
+void Grid::parent_box(int nstart)
+{
+  if (!pbox) return;
+
+  for (int i = nstart; i < nparent; i++) {
+    ParentCell *p = &pcells[i];
+    ParentBox *b = &pbox[i];
+    if (p->iparent < 0) {
+      b->lo[0] = domain->boxlo[0];
+      b->lo[1] = domain->boxlo[1];
+      b->lo[2] = domain->boxlo[2];
+      b->hi[0] = domain->boxhi[0];
+      b->hi[1] = domain->boxhi[1];
+      b->hi[2] = domain->boxhi[2];
+    } else {
+      int nbits = pcells[p->iparent].nbits;
+      cellint mask = ((cellint) 1 << pcells[p->iparent].newbits) - 1;
+      cellint ichild = (p->id >> nbits) & mask;
+      id_child_lohi(p->iparent,ichild,b->lo,b->hi);
+    }
+  }
+}
+
 /* ----------------------------------------------------------------------
    add a single split cell to sinfo
    ownflag = 1/0 if split cell is owned or ghost
@@ -336,10 +417,13 @@ void Grid::add_sub_cell(int icell, int ownflag)
 /* ----------------------------------------------------------------------
    called during a run when per-processor list of grid cells may have changed
    trigger fixes, computes, dumps to change their allocated per-grid data
+   particle cell lists can no longer be patched incrementally
 ------------------------------------------------------------------------- */
 
 void Grid::notify_changed()
 {
+  particle->incremental = 0;
+
   if (modify->n_pergrid) modify->grid_changed();
 
   Compute **compute = modify->compute;
@@ -392,6 +476,9 @@ void Grid::setup_owned()
 void Grid::remove_ghosts()
 {
   hashfilled = 0;
+  nhcell = 0;
+  ucellflag = 0;
+  nsbincell = 0;
   exist_ghost = 0;
   nghost = nunsplitghost = nsplitghost = nsubghost = 0;
   surf->remove_ghosts();
@@ -403,6 +490,7 @@ void Grid::remove_ghosts()
      explicit distributed surfs require use of hash
    method used depends on ghost cutoff
    no-op if grid is not clumped and want to acquire only nearby ghosts
+   recompute surf intersection data and rebin surfs in cells if requested
 ------------------------------------------------------------------------- */
 
 void Grid::acquire_ghosts(int surfflag)
@@ -419,6 +507,9 @@ void Grid::acquire_ghosts(int surfflag)
     surf->hash->clear();
     surf->hashfilled = 0;
   }
+
+  if (surf->cacheflag) surf->setup_cache();
+  if (surfbin) surf_bins();
 }
 
 /* ----------------------------------------------------------------------
@@ -791,8 +882,12 @@ void Grid::rehash()
   // hash all owned/ghost child and parent cell IDs
   // key = ID, value = index+1 for child cells, value = -(index+1) for parents
   // skip sub cells
+  // reserve space for all IDs up front so hash is not re-grown while filled
 
   hash->clear();
+#ifndef SPARTA_MAP
+  hash->reserve(nlocal+nghost+nparent);
+#endif
 
   for (int icell = 0; icell < nlocal+nghost; icell++) {
     if (cells[icell].nsplit <= 0) continue;
@@ -1089,6 +1184,8 @@ void Grid::find_neighbors()
     sprintf(str,"Owned cells with unknown neighbors = %d",flagall);
     error->all(FLERR,str);
   }
+
+  hot_cells();
 }
 
 /* ----------------------------------------------------------------------
@@ -1104,6 +1201,8 @@ void Grid::find_neighbors()
 void Grid::unset_neighbors()
 {
   if (!exist_ghost) return;
+  nhcell = 0;
+  ucellflag = 0;
 
   // no change in neigh[] needed if nflag = NUNKNOWN, NPBUNKNOWN, or NBOUND
 
@@ -1174,6 +1273,96 @@ void Grid::reset_neighbors()
 
     cells[icell].nmask = nmask;
   }
+
+  hot_cells();
+}
+
+/* ----------------------------------------------------------------------
+   copy fields of owned and ghost cells used by particle advection
+     into compact hcells array
+   called once neigh[] and nmask of all cells are set
+------------------------------------------------------------------------- */
+
+void Grid::hot_cells()
+{
+  int nall = nlocal + nghost;
+  if (nall > maxhcell) {
+    maxhcell = nall;
+    memory->sfree(hcells);
+    hcells = (HotCell *) 
+      memory->smalloc((bigint) maxhcell*sizeof(HotCell),"grid:hcells");
+  }
+
+  for (int icell = 0; icell < nall; icell++) {
+    ChildCell *c = &cells[icell];
+    HotCell *h = &hcells[icell];
+    h->lo[0] = c->lo[0]; h->lo[1] = c->lo[1]; h->lo[2] = c->lo[2];
+    h->hi[0] = c->hi[0]; h->hi[1] = c->hi[1]; h->hi[2] = c->hi[2];
+    for (int i = 0; i < 6; i++) h->neigh[i] = c->neigh[i];
+    h->nmask = c->nmask;
+    h->nsurf = c->nsurf;
+    h->nsplit = c->nsplit;
+    h->proc = c->proc;
+  }
+
+  nhcell = nall;
+  uniform_cells();
+}
+
+/* ----------------------------------------------------------------------
+   create dense ucell table for a uniform grid
+   maps global i,j,k of each owned cell to its local index
+   sub cells are skipped, split cells are stored, same as in hash
+   only if bounding box of my cells is not much larger than their count,
+     e.g. not for a grid decomposed without RCB
+------------------------------------------------------------------------- */
+
+void Grid::uniform_cells()
+{
+  int i,icell,ilo[3],ihi[3],ijk[3];
+
+  ucellflag = 0;
+  if (!uniform || !exist_ghost) return;
+
+  // ilo/ihi = bounding box of my cells in global i,j,k
+
+  ilo[0] = ilo[1] = ilo[2] = MAXSMALLINT;
+  ihi[0] = ihi[1] = ihi[2] = -1;
+
+  for (icell = 0; icell < nlocal; icell++) {
+    if (cells[icell].nsplit <= 0) continue;
+    uniform_ijk(cells[icell].lo,cells[icell].hi,ijk);
+    for (i = 0; i < 3; i++) {
+      ilo[i] = MIN(ilo[i],ijk[i]);
+      ihi[i] = MAX(ihi[i],ijk[i]);
+    }
+  }
+  if (ihi[0] < 0) return;
+
+  bigint ntotal = 1;
+  for (i = 0; i < 3; i++) {
+    ulo[i] = ilo[i];
+    un[i] = ihi[i] - ilo[i] + 1;
+    ntotal *= un[i];
+  }
+  if (ntotal > UCELLFACTOR*nlocal + UCELLEXTRA) return;
+
+  if (ntotal > maxucell) {
+    maxucell = ntotal;
+    memory->destroy(ucell);
+    memory->create(ucell,maxucell,"grid:ucell");
+  }
+
+  for (bigint m = 0; m < ntotal; m++) ucell[m] = -1;
+
+  for (icell = 0; icell < nlocal; icell++) {
+    if (cells[icell].nsplit <= 0) continue;
+    uniform_ijk(cells[icell].lo,cells[icell].hi,ijk);
+    ucell[((bigint) (ijk[2]-ulo[2])*un[1] + (ijk[1]-ulo[1]))*un[0] +
+          (ijk[0]-ulo[0])] = icell;
+  }
+
+  ucellflag = 1;
 }
 
 /* ----------------------------------------------------------------------
@@ -1653,6 +1842,8 @@ void Grid::check_uniform()
     }
     delete [] lflag;
   }
+
+  uniform_cells();
 }
 
 /* ----------------------------------------------------------------------
@@ -1859,6 +2050,9 @@ void Grid::grow_pcells(int n)
     pcells = (ParentCell *)
       memory->srealloc(pcells,maxparent*sizeof(ParentCell),"grid:pcells");
     memset(&pcells[oldmax],0,(maxparent-oldmax)*sizeof(ParentCell));
+    if (!pcompress)
+      pbox = (ParentBox *)
+        memory->srealloc(pbox,maxparent*sizeof(ParentBox),"grid:pbox");
   }
 }
 
@@ -2290,6 +2484,7 @@ void Grid::read_restart(FILE *fp)
 
   if (me == 0) fread(pcells,sizeof(ParentCell),nparent,fp);
   MPI_Bcast(pcells,nparent*sizeof(ParentCell),MPI_CHAR,0,world);
+  parent_box(0);
 
   // if any exist, clear existing group names, before reading new ones
 
@@ -2416,8 +2611,25 @@ bigint Grid::memory_usage()
   bytes += maxlocal * sizeof(ChildInfo);
   bytes += maxsplit * sizeof(SplitInfo);
   bytes += nparent * sizeof(ParentCell);
+  if (pbox) bytes += nparent * sizeof(ParentBox);
   bytes += csurfs->size();
   bytes += csplits->size();
+  bytes += maxhcell * sizeof(HotCell);
+  bytes += maxucell * sizeof(int);
+  if (splitcacheflag) {
+    bytes += (bigint) (scprev.max + sccur.max) * sizeof(SplitCache);
+    bytes += (scprev.maxd + sccur.maxd) * sizeof(double);
+    bytes += (scprev.maxi + sccur.maxi) * sizeof(int);
+    bytes += maxsplitreuse * sizeof(int);
+  }
+  bytes += maxsbincell * sizeof(int);
+  bytes += maxsbin * sizeof(SurfBin);
+  bytes += maxsbinstart * sizeof(int);
+  bytes += maxsbinlist * sizeof(int);
+  bytes += maxsbinbox * sizeof(unsigned char);
+#if !defined(SPARTA_MAP) && !defined(SPARTA_UNORDERED_MAP)
+  bytes += hash->memory_usage();
+#endif
 
   return bytes;
 }
@@ -46,13 +46,18 @@ class Grid : protected Pointers {
   int maxsurfpercell;   // max surf elements in one child cell
   int maxcellpersurf;   // max cells overlapping one surf element
   int maxsplitpercell;  // max split cells in one child cell
+  int surfbin;          // min # of surfs in a cell to bin them, 0 = no bins
+  int pcompress;        // 1 if parent cell lo/hi are not stored, else 0
+  int splitcacheflag;   // # of callers caching surf2grid_split() results
+  int *splitreuse;      // 1 if cached split of owned cell was reused, else 0
   
   int ngroup;               // # of defined groups
   char **gnames;            // name of each group
   int *bitmask;             // one-bit mask for each group
   int *inversemask;         // inverse mask for each group
 
-  double tmap,trvous1,trvous2,tsplit;    // timing breakdown of grid2surf()
+  double tmap,trvous1,trvous2;     // timing breakdown of grid2surf()
+  double tcutcell,tsplit;          // threaded cut of cells, serial split
 
   int copy,copymode;    // 1 if copy of class (prevents deallocation of
                         //  base class when child copy is destroyed)
@@ -64,7 +69,7 @@ class Grid : protected Pointers {
 #elif SPARTA_UNORDERED_MAP
   typedef std::unordered_map<cellint,int> MyHash;
 #else
-  typedef std::tr1::unordered_map<cellint,int> MyHash;
+  typedef FlatHash<cellint> MyHash;
 #endif
 
   MyHash *hash;
@@ -156,6 +161,8 @@ class Grid : protected Pointers {
 
   // parent cell
   // global list of parent cells is stored by all procs
+  // lo/hi of each parent cell are stored separately in pbox,
+  //   see parent_lohi()
 
   struct ParentCell {
     cellint id;               // cell ID in bitwise format, 0 = root
@@ -166,6 +173,12 @@ class Grid : protected Pointers {
     int iparent;              // index of parent, -1 if id=root
     int grandparent;          // 1 if this cell is a grandparent, 0 if not
     int nx,ny,nz;             // sub grid within cell
+  };
+
+  // extent of a parent cell, same indexing as pcells
+  // not stored if pcompress is set, then derived from cell ID on demand
+
+  struct ParentBox {
     double lo[3],hi[3];       // opposite corner pts of cell
   };
 
@@ -186,6 +199,36 @@ class Grid : protected Pointers {
   ChildInfo *cinfo;           // extra info for nlocal owned cells
   SplitInfo *sinfo;           // extra info for owned and ghost split cells
   ParentCell *pcells;         // global list of parent cells
+  ParentBox *pbox;            // extent of each parent cell, NULL if pcompress
+
+  // compact copy of the ChildCell fields used by particle advection
+  // same order as cells, one per owned and ghost cell incl sub cells
+  // used by Update::move() so each cell crossing touches less memory
+  // rebuilt by find_neighbors() and reset_neighbors() once neigh[] is set,
+  //   invalidated by any change to cells or their surfs
+
+  struct HotCell {
+    double lo[3],hi[3];       // opposite corner pts of cell
+    cellint neigh[6];         // same as ChildCell neigh
+    int nmask;                // same as ChildCell nmask
+    int nsurf;                // same as ChildCell nsurf
+    int nsplit;               // same as ChildCell nsplit
+    int proc;                 // same as ChildCell proc
+  };
+
+  int nhcell;                 // # of cells hcells is valid for, 0 if stale
+  HotCell *hcells;            // hot copy of each owned and ghost cell
+
+  // dense table from global (i,j,k) of a uniform grid to local cell index
+  // covers bounding box of my owned cells, -1 for cells I do not own
+  // used by id_find_uniform() to find owned cell containing a point
+  //   w/out walking thru parents and probing hash
+  // rebuilt with hcells and by check_uniform(), stale if ucellflag = 0
+
+  int ucellflag;              // 1 if ucell is valid
+  int ulo[3];                 // global i,j,k of 1st entry in ucell
+  int un[3];                  // extent of ucell in each dim
+  int *ucell;                 // local index of each cell, x varies fastest
 
   // restart buffers, filled by read_restart
 
@@ -193,6 +236,26 @@ class Grid : protected Pointers {
   cellint *id_restart;
   int *nsplit_restart;
 
+  // uniform bins over the csurfs of an owned or ghost cell
+  // used by Update::move() to cull surfs before exact intersection tests
+  // rebuilt by acquire_ghosts(), invalidated by remove_ghosts()
+
+  struct SurfBin {
+    int nbin[3];              // # of bins in each dim, 1 in z for 2d
+    double lo[3];             // lo corner of cell
+    double binv[3];           // inverse bin size in each dim, 0.0 in z for 2d
+    int offset;               // 1st entry in sbinstart for this cell
+    int boxoffset;            // 1st entry in sbinbox for this cell
+  };
+
+  int nsbincell;              // # of cells sbincell is valid for, 0 if stale
+  int *sbincell;              // index into sbins for each cell, -1 if none
+  SurfBin *sbins;             // bin info for each binned cell
+  int *sbinstart;             // Nbins+1 offsets into sbinlist per cell,
+                              //   bin I list = entries start[I] to start[I+1]
+  int *sbinlist;              // per bin, ascending indices into cell csurfs
+  unsigned char *sbinbox;     // per csurf, lo/hi bin in each dim, 6 values
+
   // methods
 
   Grid(class SPARTA *);
@@ -201,6 +264,7 @@ class Grid : protected Pointers {
   void init();
   void add_child_cell(cellint, int, double *, double *);
   void add_parent_cell(cellint, int, int, int, int, double *, double *);
+  void parent_box(int);
   void add_split_cell(int);
   void add_sub_cell(int, int);
   void notify_changed();
@@ -211,6 +275,8 @@ class Grid : protected Pointers {
   void find_neighbors();
   void unset_neighbors();
   void reset_neighbors();
+  void hot_cells();
+  void uniform_cells();
   void set_inout();
   void check_uniform();
   void type_check(int flag=1);
@@ -254,20 +320,26 @@ class Grid : protected Pointers {
 
   void surf2grid(int, int outflag=1);
   void surf2grid_implicit(int, int outflag=1);
+  void surf2grid_swept(double *, double *, int, int outflag=1);
   void surf2grid_one(int, int, int, int, class Cut3d *, class Cut2d *);
   void clear_surf();
   void clear_surf_restart();
+  void split_cache(int);
   void combine_split_cell_particles(int, int);
   void assign_split_cell_particles(int);
   int outside_surfs(int, double *, class Cut3d *, class Cut2d *);
   void allocate_surf_arrays();
   void allocate_cell_arrays();
   int *csubs_request(int);
+  void surf_bins();
 
   // grid_id.cpp
 
   int id_find_child(int, double *);
+  int id_find_uniform(double *);
+  void uniform_ijk(double *, double *, int *);
   int id_find_parent(cellint, cellint &);
+  void parent_lohi(int, double *, double *);
   cellint id_str2num(char *);
   void id_num2str(cellint, char *);
   void id_pc_split(char *, char *, char *);
@@ -294,12 +366,29 @@ class Grid : protected Pointers {
     return nmask;
   }
 
+  // bin of coord X in dim I for binned cell SB, clamped to cell
+  // inlined for efficiency
+
+  inline int sbin_coord(SurfBin *sb, int i, double x) {
+    int ibin = static_cast<int> ((x-sb->lo[i]) * sb->binv[i]);
+    if (ibin < 0) return 0;
+    if (ibin >= sb->nbin[i]) return sb->nbin[i]-1;
+    return ibin;
+  }
+
  protected:
   int me;
   int maxcell;             // size of cells
   int maxsplit;            // size of sinfo
   int maxparent;           // size of pcells
   int maxbits;             // max bits allowed in a cell ID
+  int maxhcell;            // size of hcells
+  bigint maxucell;         // size of ucell
+  int maxsbincell;         // size of sbincell
+  int maxsbin;             // size of sbins
+  int maxsbinstart;        // size of sbinstart
+  int maxsbinlist;         // size of sbinlist
+  int maxsbinbox;          // size of sbinbox
 
   int neighmask[6];        // bit-masks for each face in nmask
   int neighshift[6];       // bit-shifts for each face in nmask
@@ -307,6 +396,13 @@ class Grid : protected Pointers {
   class Cut2d *cut2d;
   class Cut3d *cut3d;
 
+  // per-thread copies of cut2d/cut3d for OpenMP threaded surf2grid
+  // thread 0 uses cut2d/cut3d, only exist during a surf2grid operation
+
+  int nthreads;               // # of OpenMP threads used by surf2grid
+  class Cut2d **tcut2d;
+  class Cut3d **tcut3d;
+
   // connection between one of my cells and a neighbor cell on another proc
 
   struct Connect {
@@ -322,6 +418,47 @@ class Grid : protected Pointers {
     int proc;              // proc that owns it
   };
 
+  // results of surf2grid_split() for each OVERLAP cell, if splitcacheflag set
+  // next surf2grid_split() reuses them for a cell whose surfs are identical
+  // scprev = cache from previous call, sccur = cache being built by this call
+
+  struct SplitCache {
+    cellint id;            // cell ID
+    int nsurf;             // # of surfs in cell
+    int nsplit;            // returned by Cut2d/Cut3d split()
+    int xsub;              // ditto
+    double xsplit[3];      // ditto
+    int corner[8];         // ditto
+    bigint doffset;        // offset of surf coords, then vols, in dbuf
+    bigint ioffset;        // offset of surfmap in ibuf, if nsplit > 1
+  };
+
+  struct SplitCacheList {
+    int n,max;             // # of cached cells, allocated length
+    SplitCache *cells;
+    bigint nd,maxd;        // used and allocated length of dbuf
+    double *dbuf;
+    bigint ni,maxi;        // used and allocated length of ibuf
+    int *ibuf;
+  };
+
+  SplitCacheList scprev,sccur;
+  MyHash *schash;          // cell ID -> index into scprev.cells
+  int maxsplitreuse;       // length of splitreuse
+
+  // split() outputs for one OVERLAP cell, computed by a thread
+  //   in surf2grid_split(), then used in cell order by one thread
+
+  struct SplitResult {
+    int icell;             // owned cell
+    int cache;             // index of matching cell in scprev, -1 if none
+    int nsplit;            // returned by Cut2d/Cut3d split()
+    int xsub;              // ditto
+    double xsplit[3];      // ditto
+    double *vols;          // ditto, stored in per-thread page
+    int *surfmap;          // ditto, stored in per-thread page if nsplit > 1
+  };
+
   // data structs for rendezvous comm
 
   struct InRvous {
@@ -369,9 +506,17 @@ class Grid : protected Pointers {
   void surf2grid_cell_algorithm(int);
   void surf2grid_surf_algorithm(int, int);
   void surf2grid_split(int, int);
-  int find_overlaps(int, cellint *);
-  void recurse2d(int, double *, double *, int, int &, cellint *);
-  void recurse3d(int, double *, double *, int, int &, cellint *);
+  int split_cache_match(int);
+  int split_cache_use(int, int, double *&, int *, int &, double *);
+  void split_cache_add(int, int, double *, int *, int, double *);
+  void split_cache_swap();
+  int find_overlaps(int, cellint *, class Cut3d *, class Cut2d *);
+  void recurse2d(int, double *, double *, int, int &, cellint *,
+                 class Cut2d *);
+  void recurse3d(int, double *, double *, int, int &, cellint *,
+                 class Cut3d *);
+  void create_thread_cuts();
+  void destroy_thread_cuts();
 
   void acquire_ghosts_all(int);
   void acquire_ghosts_near(int);
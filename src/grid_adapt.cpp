@@ -203,8 +203,9 @@ void Grid::coarsen_cell(int iparent, int nchild,
   // add parent as new child cell at end of my cells
   // add new child cell to grid hash
   
-  add_child_cell(pcells[iparent].id,pcells[iparent].iparent,
-                 pcells[iparent].lo,pcells[iparent].hi);
+  double plo[3],phi[3];
+  parent_lohi(iparent,plo,phi);
+  add_child_cell(pcells[iparent].id,pcells[iparent].iparent,plo,phi);
   weight_one(nlocal-1);
         
   (*hash)[pcells[iparent].id] = nlocal;
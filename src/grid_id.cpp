@@ -14,10 +14,14 @@
 
 #include "string.h"
 #include "grid.h"
+#include "domain.h"
 #include "error.h"
 
 using namespace SPARTA_NS;
 
+#define EPSUNIFORM 1.0e-6
+#define UNIFORMWALK -2
+
 // operations with grid cell IDs
 
 /* ----------------------------------------------------------------------
@@ -30,10 +34,29 @@ using namespace SPARTA_NS;
 
 int Grid::id_find_child(int iparent, double *x)
 {
+  // for a uniform grid, search from root can use ucell table for owned cells
+
+  if (iparent == 0 && ucellflag) {
+    int icell = id_find_uniform(x);
+    if (icell >= 0) return icell;
+  }
+
+  // if pbox is not stored, track lo/hi of current parent while descending
+
+  double *lo,*hi;
+  double plo[3],phi[3];
+  if (!pbox) {
+    parent_lohi(iparent,plo,phi);
+    lo = plo;
+    hi = phi;
+  }
+
   while (1) {
     ParentCell *p = &pcells[iparent];
-    double *lo = p->lo;
-    double *hi = p->hi;
+    if (pbox) {
+      lo = pbox[iparent].lo;
+      hi = pbox[iparent].hi;
+    }
     int nx = p->nx;
     int ny = p->ny;
     int nz = p->nz;
@@ -51,6 +74,73 @@ int Grid::id_find_child(int iparent, double *x)
     int index = (*hash)[idchild];
     if (index > 0) return index-1;
     iparent = -index-1;
+
+    // lo/hi of new parent cell
+    // exact same math as in id_child_lohi()
+
+    if (!pbox) {
+      double newlo[3],newhi[3];
+      newlo[0] = lo[0] + ix*(hi[0]-lo[0])/nx;
+      newlo[1] = lo[1] + iy*(hi[1]-lo[1])/ny;
+      newlo[2] = lo[2] + iz*(hi[2]-lo[2])/nz;
+      newhi[0] = lo[0] + (ix+1)*(hi[0]-lo[0])/nx;
+      newhi[1] = lo[1] + (iy+1)*(hi[1]-lo[1])/ny;
+      newhi[2] = lo[2] + (iz+1)*(hi[2]-lo[2])/nz;
+      if (ix == nx-1) newhi[0] = hi[0];
+      if (iy == ny-1) newhi[1] = hi[1];
+      if (iz == nz-1) newhi[2] = hi[2];
+      memcpy(plo,newlo,3*sizeof(double));
+      memcpy(phi,newhi,3*sizeof(double));
+    }
+  }
+}
+
+/* ----------------------------------------------------------------------
+   find owned child cell of a uniform grid containing pt x via ucell table
+   x must be inside or on surface of simulation box
+   return -1 if I don't own child cell, else local index of child cell
+   return UNIFORMWALK if x is within EPSUNIFORM of a cell face,
+     since walk thru parents in id_find_child() could then pick a
+     different cell due to round-off, caller should use it instead
+------------------------------------------------------------------------- */
+
+int Grid::id_find_uniform(double *x)
+{
+  int ijk[3];
+
+  double *boxlo = domain->boxlo;
+  double *prd = domain->prd;
+  int unxyz[3] = {unx,uny,unz};
+
+  for (int i = 0; i < 3; i++) {
+    double frac = (x[i]-boxlo[i]) * unxyz[i]/prd[i];
+    ijk[i] = static_cast<int> (frac);
+    if (ijk[i] == unxyz[i]) ijk[i]--;
+    frac -= ijk[i];
+    if (unxyz[i] > 1 && (frac < EPSUNIFORM || frac > 1.0-EPSUNIFORM))
+      return UNIFORMWALK;
+    ijk[i] -= ulo[i];
+    if (ijk[i] < 0 || ijk[i] >= un[i]) return -1;
+  }
+
+  return ucell[((bigint) ijk[2]*un[1] + ijk[1])*un[0] + ijk[0]];
+}
+
+/* ----------------------------------------------------------------------
+   global i,j,k of a uniform grid child cell with corner pts lo,hi
+------------------------------------------------------------------------- */
+
+void Grid::uniform_ijk(double *lo, double *hi, int *ijk)
+{
+  double *boxlo = domain->boxlo;
+  double *prd = domain->prd;
+  int unxyz[3] = {unx,uny,unz};
+
+  for (int i = 0; i < 3; i++) {
+    ijk[i] = static_cast<int>
+      ((0.5*(lo[i]+hi[i]) - boxlo[i]) * unxyz[i]/prd[i]);
+    if (ijk[i] >= unxyz[i]) ijk[i] = unxyz[i]-1;
+    if (ijk[i] < 0) ijk[i] = 0;
   }
 }
 
@@ -188,6 +278,40 @@ void Grid::id_pc_split(char *idstr, char *parent, char *child)
   return;
 }
 
+/* ----------------------------------------------------------------------
+   compute lo/hi extent of parent cell iparent
+   if pbox is stored, just copy it
+   else derive it from cell ID by recursing up to root cell,
+     same math as when parent cell was created, so result is identical
+------------------------------------------------------------------------- */
+
+void Grid::parent_lohi(int iparent, double *lo, double *hi)
+{
+  if (pbox) {
+    double *plo = pbox[iparent].lo;
+    double *phi = pbox[iparent].hi;
+    lo[0] = plo[0]; lo[1] = plo[1]; lo[2] = plo[2];
+    hi[0] = phi[0]; hi[1] = phi[1]; hi[2] = phi[2];
+    return;
+  }
+
+  ParentCell *p = &pcells[iparent];
+  if (p->iparent < 0) {
+    lo[0] = domain->boxlo[0];
+    lo[1] = domain->boxlo[1];
+    lo[2] = domain->boxlo[2];
+    hi[0] = domain->boxhi[0];
+    hi[1] = domain->boxhi[1];
+    hi[2] = domain->boxhi[2];
+    return;
+  }
+
+  int nbits = pcells[p->iparent].nbits;
+  cellint mask = ((cellint) 1 << pcells[p->iparent].newbits) - 1;
+  cellint ichild = (p->id >> nbits) & mask;
+  id_child_lohi(p->iparent,ichild,lo,hi);
+}
+
 /* ----------------------------------------------------------------------
    compute lo/hi extent of a specific child cell within a parent cell
    iparent = index of parent cell, has Nx by Ny by Nz children
@@ -207,8 +331,8 @@ void Grid::id_child_lohi(int iparent, cellint ichild, double *lo, double *hi)
   int iy = (ichild/nx) % ny;
   int iz = ichild / ((bigint) nx*ny);
 
-  double *plo = p->lo;
-  double *phi = p->hi;
+  double plo[3],phi[3];
+  parent_lohi(iparent,plo,phi);
 
   lo[0] = plo[0] + ix*(phi[0]-plo[0])/nx;
   lo[1] = plo[1] + iy*(phi[1]-plo[1])/ny;
@@ -251,8 +375,8 @@ cellint Grid::id_find_face(double *x, int icell, int dim,
                            double *olo, double *ohi)
 {
   ParentCell *p = &pcells[icell];
-  double *lo = p->lo;
-  double *hi = p->hi;
+  double lo[3],hi[3];
+  parent_lohi(icell,lo,hi);
 
   // go down a level to find (ix,iy,iz) of new cell that contains pt x
 
@@ -12,6 +12,7 @@
    See the README file in the top-level SPARTA directory.
 ------------------------------------------------------------------------- */
 
+#include "math.h"
 #include "string.h"
 #include "grid.h"
 #include "domain.h"
@@ -32,6 +33,10 @@
 #include "memory.h"
 #include "error.h"
 
+#if defined(_OPENMP)
+#include "omp.h"
+#endif
+
 using namespace SPARTA_NS;
 using namespace MathConst;
 
@@ -41,7 +46,12 @@ int compare_surfIDs(const void *, const void *);
 
 #define BIG 1.0e20
 #define CHUNK 16
+#define TCHUNK 64          // cells or surfs per dynamic chunk of a thread
 #define EPSSURF 1.0e-4
+#define SBINSURF 2         // target # of surfs per bin
+#define MAXSBIN 16         // max bins per dim in one cell
+#define EPSSBIN 1.0e-6     // pad of surf bbox, as fraction of cell size
+#define DELTASBIN 1024
 
 enum{UNKNOWN,OUTSIDE,INSIDE,OVERLAP};   // several files
 enum{PERAUTO,PERCELL,PERSURF};          // several files
@@ -107,16 +117,41 @@ void Grid::surf2grid_cell_algorithm(int outflag)
 
   if (dim == 3) cut3d = new Cut3d(sparta);
   else cut2d = new Cut2d(sparta,domain->axisymmetric);
+  create_thread_cuts();
 
   // compute overlap of surfs with each cell I own
   // info stored in nsurf,csurfs
   // skip if nsplit <= 0 b/c split cells could exist if restarting
+  // cells are split dynamically across threads b/c overlaps are clustered
+  // if threaded, each thread stores lists in its own page,
+  //   copied to csurfs in cell order after the loop
 
   Surf::Line *lines = surf->lines;
   Surf::Tri *tris = surf->tris;
 
+  MyPage<surfint> **tpage = new MyPage<surfint>*[nthreads];
+  if (nthreads == 1) tpage[0] = csurfs;
+  else
+    for (int ithread = 0; ithread < nthreads; ithread++)
+      tpage[ithread] = 
+        new MyPage<surfint>(maxsurfpercell,MAX(100*maxsurfpercell,1024));
+
   int max = 0;
-  
+
+#if defined(_OPENMP)
+#pragma omp parallel num_threads(nthreads) \
+  private(i,nsurf,nontrans,ptr,lo,hi) reduction(max:max)
+#endif
+  {
+  int ithread = 0;
+#if defined(_OPENMP)
+  ithread = omp_get_thread_num();
+#endif
+  MyPage<surfint> *page = tpage[ithread];
+
+#if defined(_OPENMP)
+#pragma omp for schedule(dynamic,TCHUNK)
+#endif
   for (int icell = 0; icell < nlocal; icell++) {
     if (cells[icell].nsplit <= 0) continue;
 
@@ -124,20 +159,20 @@ void Grid::surf2grid_cell_algorithm(int outflag)
     hi = cells[icell].hi;
     if (!box_overlap(lo,hi,slo,shi)) continue;
 
-    ptr = csurfs->vget();
+    ptr = page->vget();
 
     if (dim == 3)
-      nsurf = cut3d->surf2grid(cells[icell].id,cells[icell].lo,cells[icell].hi,
-                               ptr,maxsurfpercell);
+      nsurf = tcut3d[ithread]->surf2grid(cells[icell].id,lo,hi,
+                                         ptr,maxsurfpercell);
     else
-      nsurf = cut2d->surf2grid(cells[icell].id,cells[icell].lo,cells[icell].hi,
-                               ptr,maxsurfpercell);
+      nsurf = tcut2d[ithread]->surf2grid(cells[icell].id,lo,hi,
+                                         ptr,maxsurfpercell);
 
     if (nsurf > maxsurfpercell) {
       max = MAX(max,nsurf);
-      csurfs->vgot(0);
+      page->vgot(0);
     } else if (nsurf) {
-      csurfs->vgot(nsurf);
+      page->vgot(nsurf);
       cells[icell].nsurf = nsurf;
       cells[icell].csurfs = ptr;
 
@@ -161,6 +196,21 @@ void Grid::surf2grid_cell_algorithm(int outflag)
       if (nontrans) cinfo[icell].type = OVERLAP;
     }
   }
+  }
+
+  if (nthreads > 1) {
+    for (int icell = 0; icell < nlocal; icell++) {
+      if (cells[icell].nsplit <= 0 || !cells[icell].nsurf) continue;
+      nsurf = cells[icell].nsurf;
+      ptr = csurfs->vget();
+      memcpy(ptr,cells[icell].csurfs,nsurf*sizeof(surfint));
+      csurfs->vgot(nsurf);
+      cells[icell].csurfs = ptr;
+    }
+    for (int ithread = 0; ithread < nthreads; ithread++) delete tpage[ithread];
+  }
+  delete [] tpage;
+  destroy_thread_cuts();
 
   // error if surf count exceeds maxsurfpercell in any cell
 
@@ -200,6 +250,7 @@ void Grid::surf2grid_surf_algorithm(int subflag, int outflag)
 
   int dim = domain->dimension;
   int distributed = surf->distributed;
+  t1 = t2 = t3 = 0.0;
 
   if (dim == 3) cut3d = new Cut3d(sparta);
   else cut2d = new Cut2d(sparta,domain->axisymmetric);
@@ -224,7 +275,7 @@ void Grid::surf2grid_surf_algorithm(int subflag, int outflag)
 
   Surf::Line *surf_lines;
   Surf::Tri *surf_tris;
-  int nsurf,istart,istop,idelta;
+  int nsurf,istart,idelta;
   int nprocs = comm->nprocs;
 
   if (distributed) {
@@ -232,7 +283,6 @@ void Grid::surf2grid_surf_algorithm(int subflag, int outflag)
     surf_tris = surf->mytris;
     nsurf = surf->nown;
     istart = 0;
-    istop = nsurf;
     idelta = 1;
   } else {
     surf_lines = surf->lines;
@@ -241,7 +291,6 @@ void Grid::surf2grid_surf_algorithm(int subflag, int outflag)
     nsurf = ntotal / nprocs;
     if (me < ntotal % nprocs) nsurf++;
     istart = comm->me;
-    istop = ntotal;
     idelta = nprocs;
   }
 
@@ -255,25 +304,55 @@ void Grid::surf2grid_surf_algorithm(int subflag, int outflag)
   // overlap test is performed for each cell that overlaps surf bbox
   //   via call to cut2d/3d->surf2grid_one()
 
+  // surfs are split dynamically across threads
+  // each thread stores cell lists in its own page, thread 0 uses cpsurf
+  // pages are freed after rendezvous input is built
+
+  create_thread_cuts();
+
+  MyPage<cellint> **tpage = new MyPage<cellint>*[nthreads];
+  tpage[0] = cpsurf;
+  for (int ithread = 1; ithread < nthreads; ithread++)
+    tpage[ithread] = 
+      new MyPage<cellint>(maxcellpersurf,MAX(100*maxcellpersurf,1024));
+
   int ncell;
   cellint *ptr;
 
   int max = 0;
-  m = 0;
-  for (isurf = istart; isurf < istop; isurf += idelta) {
-    ptr = cpsurf->vget();
-    ncell = find_overlaps(isurf,ptr);
+
+#if defined(_OPENMP)
+#pragma omp parallel num_threads(nthreads) \
+  private(isurf,ncell,ptr) reduction(max:max)
+#endif
+  {
+  int ithread = 0;
+#if defined(_OPENMP)
+  ithread = omp_get_thread_num();
+#endif
+  MyPage<cellint> *page = tpage[ithread];
+
+#if defined(_OPENMP)
+#pragma omp for schedule(dynamic,TCHUNK)
+#endif
+  for (int k = 0; k < nsurf; k++) {
+    isurf = istart + k*idelta;
+    ptr = page->vget();
+    ncell = find_overlaps(isurf,ptr,tcut3d[ithread],tcut2d[ithread]);
 
     if (ncell > maxcellpersurf) {
       max = MAX(max,ncell);
-      cpsurf->vgot(0);
+      page->vgot(0);
+      cellcount[k] = 0;
     } else {
-      cpsurf->vgot(ncell);
-      cellcount[m] = ncell;
-      celllist[m] = ptr;
-      m++;
+      page->vgot(ncell);
+      cellcount[k] = ncell;
+      celllist[k] = ptr;
     }
   }
+  }
+
+  destroy_thread_cuts();
 
   // error if cell count exceeds maxcellpersurf for any surf
 
@@ -345,6 +424,8 @@ void Grid::surf2grid_surf_algorithm(int subflag, int outflag)
   memory->destroy(cellcount);
   memory->sfree(celllist);
   cpsurf->reset();
+  for (int ithread = 1; ithread < nthreads; ithread++) delete tpage[ithread];
+  delete [] tpage;
 
   // perform rendezvous operation
   // each proc owns random subset of cells
@@ -600,6 +681,202 @@ void Grid::surf2grid_implicit(int subflag, int outflag)
   surf2grid_split(subflag,outflag);
 }
 
+/* ----------------------------------------------------------------------
+   re-map surfs to owned grid cells after a subset of surfs has moved
+   replaces clear_surf() + surf2grid() when moved surfs are localized
+   slo,shi = bbox of moved surfs at both their old and new positions
+   only cells overlapping slo/shi are intersected with surfs again,
+     candidates = cell's previous surfs + all surfs overlapping slo/shi,
+     so nsurf,csurfs are same as for surf2grid_cell_algorithm()
+   all other cells keep their previous nsurf,csurfs
+   if split cache is enabled, surf2grid_split() only re-cuts changed cells
+   called from FixMoveSurf, surfs cannot be distributed
+------------------------------------------------------------------------- */
+
+void Grid::surf2grid_swept(double *slo, double *shi, int subflag, int outflag)
+{
+  int i,j,k,m,n,nprev,ncand,nsurf,nontrans;
+  double t1 = 0.0,t2;
+  surfint *ptr,*prev = NULL;
+  double *lo,*hi;
+
+  int dim = domain->dimension;
+
+  if (outflag) {
+    MPI_Barrier(world);
+    t1 = MPI_Wtime();
+  }
+
+  // stash previous csurfs of each owned cell, hash = cell ID -> stash index
+  // sub cells are skipped, their split cell has the same list
+  // sort each list, since AdaptGrid can leave them unsorted,
+  //   so lists are in same order as surf2grid_cell_algorithm()
+
+  int nstash = 0;
+  bigint nstashsurf = 0;
+  for (int icell = 0; icell < nlocal; icell++)
+    if (cells[icell].nsplit >= 1 && cells[icell].nsurf) {
+      nstash++;
+      nstashsurf += cells[icell].nsurf;
+    }
+
+  int *stashfirst,*stashcount;
+  surfint *stashsurfs;
+  memory->create(stashfirst,nstash,"grid:stashfirst");
+  memory->create(stashcount,nstash,"grid:stashcount");
+  memory->create(stashsurfs,nstashsurf,"grid:stashsurfs");
+  MyHash *sweptstash = new MyHash();
+
+  nstash = 0;
+  nstashsurf = 0;
+  for (int icell = 0; icell < nlocal; icell++)
+    if (cells[icell].nsplit >= 1 && cells[icell].nsurf) {
+      n = cells[icell].nsurf;
+      memcpy(&stashsurfs[nstashsurf],cells[icell].csurfs,n*sizeof(surfint));
+      qsort(&stashsurfs[nstashsurf],n,sizeof(surfint),compare_surfIDs);
+      stashfirst[nstash] = nstashsurf;
+      stashcount[nstash] = n;
+      (*sweptstash)[cells[icell].id] = nstash;
+      nstash++;
+      nstashsurf += n;
+    }
+
+  clear_surf();
+
+  // list of surfs overlapping slo/shi, in ascending order
+  // includes all moved surfs
+
+  Surf::Line *lines = surf->lines;
+  Surf::Tri *tris = surf->tris;
+  int ntotal = surf->nsurf;
+
+  surfint *boxsurfs,*cand;
+  memory->create(boxsurfs,ntotal,"grid:boxsurfs");
+  memory->create(cand,ntotal+maxsurfpercell,"grid:cand");
+
+  double *p1,*p2,*p3;
+  int nbox = 0;
+
+  for (m = 0; m < ntotal; m++) {
+    if (dim == 2) {
+      p1 = lines[m].p1;
+      p2 = lines[m].p2;
+      if (MAX(p1[0],p2[0]) < slo[0] || MIN(p1[0],p2[0]) > shi[0]) continue;
+      if (MAX(p1[1],p2[1]) < slo[1] || MIN(p1[1],p2[1]) > shi[1]) continue;
+    } else {
+      p1 = tris[m].p1;
+      p2 = tris[m].p2;
+      p3 = tris[m].p3;
+      if (MAX(MAX(p1[0],p2[0]),p3[0]) < slo[0] ||
+          MIN(MIN(p1[0],p2[0]),p3[0]) > shi[0]) continue;
+      if (MAX(MAX(p1[1],p2[1]),p3[1]) < slo[1] ||
+          MIN(MIN(p1[1],p2[1]),p3[1]) > shi[1]) continue;
+      if (MAX(MAX(p1[2],p2[2]),p3[2]) < slo[2] ||
+          MIN(MIN(p1[2],p2[2]),p3[2]) > shi[2]) continue;
+    }
+    boxsurfs[nbox++] = m;
+  }
+
+  if (dim == 3) cut3d = new Cut3d(sparta);
+  else cut2d = new Cut2d(sparta,domain->axisymmetric);
+
+  // reset nsurf,csurfs for each cell
+  // cell outside slo/shi = copy of stashed list
+  // cell overlapping slo/shi = candidates clipped against cell,
+  //   candidates = merge of stashed list and boxsurfs, both are sorted
+
+  int max = 0;
+
+  for (int icell = 0; icell < nlocal; icell++) {
+    if (cells[icell].nsplit <= 0) continue;
+
+    nprev = 0;
+    if (sweptstash->find(cells[icell].id) != sweptstash->end()) {
+      k = (*sweptstash)[cells[icell].id];
+      prev = &stashsurfs[stashfirst[k]];
+      nprev = stashcount[k];
+    }
+
+    lo = cells[icell].lo;
+    hi = cells[icell].hi;
+    int inside = 1;
+    for (int idim = 0; idim < dim; idim++)
+      if (hi[idim] < slo[idim] || lo[idim] > shi[idim]) inside = 0;
+
+    ptr = csurfs->vget();
+
+    if (!inside) {
+      if (!nprev) continue;
+      memcpy(ptr,prev,nprev*sizeof(surfint));
+      nsurf = nprev;
+
+    } else {
+      i = j = ncand = 0;
+      while (i < nprev || j < nbox) {
+        if (j == nbox || (i < nprev && prev[i] < boxsurfs[j]))
+          cand[ncand++] = prev[i++];
+        else if (i == nprev || boxsurfs[j] < prev[i])
+          cand[ncand++] = boxsurfs[j++];
+        else {
+          cand[ncand++] = prev[i++];
+          j++;
+        }
+      }
+
+      if (dim == 3)
+        nsurf = cut3d->surf2grid_list(cells[icell].id,lo,hi,ncand,cand,
+                                      ptr,maxsurfpercell);
+      else
+        nsurf = cut2d->surf2grid_list(cells[icell].id,lo,hi,ncand,cand,
+                                      ptr,maxsurfpercell);
+
+      if (nsurf > maxsurfpercell) {
+        max = MAX(max,nsurf);
+        csurfs->vgot(0);
+        continue;
+      }
+      if (!nsurf) continue;
+    }
+
+    csurfs->vgot(nsurf);
+    cells[icell].nsurf = nsurf;
+    cells[icell].csurfs = ptr;
+
+    // only mark cell as OVERLAP if has a non-transparent surf element
+    // same test as surf2grid_cell_algorithm()
+
+    if (dim == 2) nontrans = !lines[ptr[0]].transparent;
+    else nontrans = !tris[ptr[0]].transparent;
+    if (nontrans) cinfo[icell].type = OVERLAP;
+  }
+
+  memory->destroy(stashfirst);
+  memory->destroy(stashcount);
+  memory->destroy(stashsurfs);
+  memory->destroy(boxsurfs);
+  memory->destroy(cand);
+  delete sweptstash;
+
+  // error if surf count exceeds maxsurfpercell in any cell
+
+  int maxall;
+  MPI_Allreduce(&max,&maxall,1,MPI_INT,MPI_MAX,world);
+  if (maxall) {
+    if (me == 0) printf("Max surfs in any cell = %d\n",maxall);
+    error->all(FLERR,"Too many surfs in one cell - set global surfmax");
+  }
+
+  if (outflag) {
+    MPI_Barrier(world);
+    t2 = MPI_Wtime();
+    tmap = t2-t1;
+    trvous1 = trvous2 = 0.0;
+  }
+
+  if (outflag) surf2grid_stats();
+  surf2grid_split(subflag,outflag);
+}
+
 /* ----------------------------------------------------------------------
    compute cut volume of each cell and any split cell info
    nsurf and csurfs list for each grid cell have already been computed
@@ -614,15 +891,16 @@ void Grid::surf2grid_implicit(int subflag, int outflag)
 
 void Grid::surf2grid_split(int subflag, int outflag)
 {
-  int i,isub,nsurf,nsplitone,xsub;
+  int i,isub,nsplitone,xsub;
   int *surfmap,*ptr;
-  double t1,t2;
-  double *lo,*hi,*vols;
+  double t1,t2,t3;
+  double *vols;
   double xsplit[3];
   ChildCell *c;
   SplitInfo *s;
 
   int dim = domain->dimension;
+  t1 = t2 = t3 = 0.0;
 
   if (outflag) {
     MPI_Barrier(world);
@@ -636,20 +914,130 @@ void Grid::surf2grid_split(int subflag, int outflag)
 
   int max = 0;
   int ncurrent = nlocal;
+
+  // if caching, splitreuse = 1 for each cell whose cached split is reused
   
-  for (int icell = 0; icell < ncurrent; icell++) {
-    if (cells[icell].nsplit <= 0) continue;
-    if (cinfo[icell].type != OVERLAP) continue;
+  if (splitcacheflag) {
+    if (ncurrent > maxsplitreuse) {
+      memory->destroy(splitreuse);
+      maxsplitreuse = ncurrent;
+      memory->create(splitreuse,maxsplitreuse,"grid:splitreuse");
+    }
+    for (int icell = 0; icell < ncurrent; icell++) splitreuse[icell] = 0;
+  }
 
-    surfmap = csplits->vget();
-    c = &cells[icell];
+  // list of OVERLAP cells to split
+
+  int noverlap = 0;
+  for (int icell = 0; icell < ncurrent; icell++)
+    if (cells[icell].nsplit > 0 && cinfo[icell].type == OVERLAP) noverlap++;
+
+  SplitResult *results = (SplitResult *) 
+    memory->smalloc(noverlap*sizeof(SplitResult),"grid:results");
+
+  noverlap = 0;
+  for (int icell = 0; icell < ncurrent; icell++)
+    if (cells[icell].nsplit > 0 && cinfo[icell].type == OVERLAP)
+      results[noverlap++].icell = icell;
+
+  // stage 1: threads call Cut2d/Cut3d split() for cells not in cache
+  // cells are split dynamically across threads b/c cut costs vary widely
+  // split() sets cinfo corner flags of its cell directly
+  // vols and surfmap are stored in per-thread pages
+
+  create_thread_cuts();
+
+  MyPage<double> **tvols = new MyPage<double>*[nthreads];
+  MyPage<int> **tmaps = new MyPage<int>*[nthreads];
+  for (int ithread = 0; ithread < nthreads; ithread++) {
+    tvols[ithread] = 
+      new MyPage<double>(maxsplitpercell,MAX(100*maxsplitpercell,1024));
+    tmaps[ithread] = 
+      new MyPage<int>(maxsurfpercell,MAX(100*maxsurfpercell,1024));
+  }
 
+#if defined(_OPENMP)
+#pragma omp parallel num_threads(nthreads) private(c,vols,surfmap)
+#endif
+  {
+  int ithread = 0;
+#if defined(_OPENMP)
+  ithread = omp_get_thread_num();
+#endif
+  SplitResult *r;
+
+#if defined(_OPENMP)
+#pragma omp for schedule(dynamic,TCHUNK)
+#endif
+  for (int k = 0; k < noverlap; k++) {
+    r = &results[k];
+    c = &cells[r->icell];
+
+    r->cache = -1;
+    if (splitcacheflag) r->cache = split_cache_match(r->icell);
+    if (r->cache >= 0) continue;
+
+    surfmap = tmaps[ithread]->vget();
     if (dim == 3)
-      nsplitone = cut3d->split(c->id,c->lo,c->hi,c->nsurf,c->csurfs,
-                               vols,surfmap,cinfo[icell].corner,xsub,xsplit);
+      r->nsplit = tcut3d[ithread]->split(c->id,c->lo,c->hi,c->nsurf,c->csurfs,
+                                         vols,surfmap,cinfo[r->icell].corner,
+                                         r->xsub,r->xsplit);
     else
-      nsplitone = cut2d->split(c->id,c->lo,c->hi,c->nsurf,c->csurfs,
-                               vols,surfmap,cinfo[icell].corner,xsub,xsplit);
+      r->nsplit = tcut2d[ithread]->split(c->id,c->lo,c->hi,c->nsurf,c->csurfs,
+                                         vols,surfmap,cinfo[r->icell].corner,
+                                         r->xsub,r->xsplit);
+
+    r->surfmap = NULL;
+    if (r->nsplit > 1) {
+      r->surfmap = surfmap;
+      tmaps[ithread]->vgot(c->nsurf);
+    }
+
+    r->vols = NULL;
+    if (r->nsplit <= maxsplitpercell) {
+      r->vols = tvols[ithread]->vget();
+      memcpy(r->vols,vols,r->nsplit*sizeof(double));
+      tvols[ithread]->vgot(r->nsplit);
+    }
+  }
+  }
+
+  destroy_thread_cuts();
+
+  if (outflag) {
+    MPI_Barrier(world);
+    t2 = MPI_Wtime();
+    tcutcell = t2-t1;
+  }
+
+  // stage 2: use split() results in cell order
+  // cells with too many splits are only counted for the error check
+
+  for (int k = 0; k < noverlap; k++) {
+    SplitResult *r = &results[k];
+    int icell = r->icell;
+
+    surfmap = csplits->vget();
+
+    if (r->cache >= 0) {
+      nsplitone = split_cache_use(icell,r->cache,vols,surfmap,xsub,xsplit);
+      splitreuse[icell] = 1;
+    } else {
+      nsplitone = r->nsplit;
+      if (nsplitone > maxsplitpercell) {
+        max = MAX(max,nsplitone);
+        continue;
+      }
+      vols = r->vols;
+      xsub = r->xsub;
+      xsplit[0] = r->xsplit[0];
+      xsplit[1] = r->xsplit[1];
+      xsplit[2] = r->xsplit[2];
+      if (nsplitone > 1) 
+        memcpy(surfmap,r->surfmap,cells[icell].nsurf*sizeof(int));
+      if (splitcacheflag)
+        split_cache_add(icell,nsplitone,vols,surfmap,xsub,xsplit);
+    }
 
     if (nsplitone == 1) {
       cinfo[icell].volume = vols[0];
@@ -721,6 +1109,16 @@ void Grid::surf2grid_split(int subflag, int outflag)
     }
   }
 
+  memory->sfree(results);
+  for (int ithread = 0; ithread < nthreads; ithread++) {
+    delete tvols[ithread];
+    delete tmaps[ithread];
+  }
+  delete [] tvols;
+  delete [] tmaps;
+
+  if (splitcacheflag) split_cache_swap();
+
   // error if split count exceeds maxsplitpercell for any cell
 
   int maxall;
@@ -796,8 +1194,8 @@ void Grid::surf2grid_split(int subflag, int outflag)
 
   if (outflag) {
     MPI_Barrier(world);
-    t2 = MPI_Wtime();
-    tsplit = t2-t1;
+    t3 = MPI_Wtime();
+    tsplit = t3-t2;
   }
 }
 
@@ -902,6 +1300,264 @@ void Grid::surf2grid_one(int flag, int icell, int iparent, int nsurf_caller,
   }
 }
 
+/* ----------------------------------------------------------------------
+   create per-thread Cut2d/Cut3d for OpenMP threaded surf2grid operations
+   thread 0 uses cut2d/cut3d, which caller has already created
+------------------------------------------------------------------------- */
+
+void Grid::create_thread_cuts()
+{
+  nthreads = 1;
+#if defined(_OPENMP)
+  nthreads = omp_get_max_threads();
+#endif
+
+  tcut3d = new Cut3d*[nthreads];
+  tcut2d = new Cut2d*[nthreads];
+  for (int i = 0; i < nthreads; i++) {
+    tcut3d[i] = NULL;
+    tcut2d[i] = NULL;
+  }
+
+  if (domain->dimension == 3) {
+    tcut3d[0] = cut3d;
+    for (int i = 1; i < nthreads; i++) tcut3d[i] = new Cut3d(sparta);
+  } else {
+    tcut2d[0] = cut2d;
+    for (int i = 1; i < nthreads; i++)
+      tcut2d[i] = new Cut2d(sparta,domain->axisymmetric);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   delete per-thread Cut2d/Cut3d
+   sum their pushed cell tallies into cut2d/cut3d for surf2grid_split() stats
+------------------------------------------------------------------------- */
+
+void Grid::destroy_thread_cuts()
+{
+  if (domain->dimension == 3) {
+    for (int i = 1; i < nthreads; i++) {
+      for (int m = 0; m <= cut3d->npushmax; m++)
+        cut3d->npushcell[m] += tcut3d[i]->npushcell[m];
+      delete tcut3d[i];
+    }
+  } else {
+    for (int i = 1; i < nthreads; i++) {
+      for (int m = 0; m <= cut2d->npushmax; m++)
+        cut2d->npushcell[m] += tcut2d[i]->npushcell[m];
+      delete tcut2d[i];
+    }
+  }
+
+  delete [] tcut3d;
+  delete [] tcut2d;
+  tcut3d = NULL;
+  tcut2d = NULL;
+}
+
+/* ----------------------------------------------------------------------
+   enable or disable caching of surf2grid_split() results
+   flag = 1 to enable, 0 to disable and free the cache
+   used by callers which re-create surfs often while most are unchanged,
+     e.g. FixAblate and FixMoveSurf, so the costly Cut2d/Cut3d split()
+     is only performed for cells whose surfs have changed
+   splitcacheflag counts callers, cache is freed when last one disables it
+------------------------------------------------------------------------- */
+
+void Grid::split_cache(int flag)
+{
+  if (flag) {
+    splitcacheflag++;
+    if (!schash) schash = new MyHash();
+    return;
+  }
+
+  if (splitcacheflag) splitcacheflag--;
+  if (splitcacheflag) return;
+
+  SplitCacheList *lists[2] = {&scprev,&sccur};
+  for (int m = 0; m < 2; m++) {
+    memory->sfree(lists[m]->cells);
+    memory->destroy(lists[m]->dbuf);
+    memory->destroy(lists[m]->ibuf);
+    memset(lists[m],0,sizeof(SplitCacheList));
+  }
+  memory->destroy(splitreuse);
+  splitreuse = NULL;
+  maxsplitreuse = 0;
+  delete schash;
+  schash = NULL;
+}
+
+/* ----------------------------------------------------------------------
+   look up owned cell icell in cache from previous surf2grid_split()
+   match requires same # of surfs with identical coords, in same order
+   return index of match in scprev, -1 if no match
+   only reads cache, so can be called by multiple threads
+------------------------------------------------------------------------- */
+
+int Grid::split_cache_match(int icell)
+{
+  MyHash::iterator it = schash->find(cells[icell].id);
+  if (it == schash->end()) return -1;
+
+  SplitCache *sc = &scprev.cells[it->second];
+  int nsurf = cells[icell].nsurf;
+  if (sc->nsurf != nsurf) return -1;
+
+  // compare surf coords and transparent flag to cached values
+
+  surfint *csurfs = cells[icell].csurfs;
+  double *dbuf = &scprev.dbuf[sc->doffset];
+  int m = 0;
+
+  if (domain->dimension == 3) {
+    Surf::Tri *tris = surf->tris;
+    Surf::Tri *tri;
+    for (int i = 0; i < nsurf; i++) {
+      tri = &tris[csurfs[i]];
+      if (memcmp(&dbuf[m],tri->p1,3*sizeof(double)) ||
+          memcmp(&dbuf[m+3],tri->p2,3*sizeof(double)) ||
+          memcmp(&dbuf[m+6],tri->p3,3*sizeof(double)) ||
+          dbuf[m+9] != tri->transparent) return -1;
+      m += 10;
+    }
+  } else {
+    Surf::Line *lines = surf->lines;
+    Surf::Line *line;
+    for (int i = 0; i < nsurf; i++) {
+      line = &lines[csurfs[i]];
+      if (memcmp(&dbuf[m],line->p1,3*sizeof(double)) ||
+          memcmp(&dbuf[m+3],line->p2,3*sizeof(double)) ||
+          dbuf[m+6] != line->transparent) return -1;
+      m += 7;
+    }
+  }
+
+  return it->second;
+}
+
+/* ----------------------------------------------------------------------
+   use cached split of owned cell icell, index = match from split_cache_match()
+   return Cut2d/Cut3d split() outputs via args, set corner flags,
+     add cell to cache for this call, and return nsplit
+------------------------------------------------------------------------- */
+
+int Grid::split_cache_use(int icell, int index, double *&vols, int *surfmap,
+                          int &xsub, double *xsplit)
+{
+  SplitCache *sc = &scprev.cells[index];
+  int nsurf = cells[icell].nsurf;
+  int nper = 7;
+  if (domain->dimension == 3) nper = 10;
+
+  // vols points into scprev, which is unchanged until split_cache_swap()
+
+  vols = &scprev.dbuf[sc->doffset + (bigint) nsurf*nper];
+  if (sc->nsplit > 1) 
+    memcpy(surfmap,&scprev.ibuf[sc->ioffset],nsurf*sizeof(int));
+  memcpy(cinfo[icell].corner,sc->corner,8*sizeof(int));
+  xsub = sc->xsub;
+  xsplit[0] = sc->xsplit[0];
+  xsplit[1] = sc->xsplit[1];
+  xsplit[2] = sc->xsplit[2];
+
+  split_cache_add(icell,sc->nsplit,vols,surfmap,xsub,xsplit);
+  return sc->nsplit;
+}
+
+/* ----------------------------------------------------------------------
+   add Cut2d/Cut3d split() outputs for owned cell icell to cache
+   also store coords and transparent flag of its surfs, for later matching
+------------------------------------------------------------------------- */
+
+void Grid::split_cache_add(int icell, int nsplitone, double *vols,
+                           int *surfmap, int xsub, double *xsplit)
+{
+  int nsurf = cells[icell].nsurf;
+  int nper = 7;
+  if (domain->dimension == 3) nper = 10;
+
+  if (sccur.n == sccur.max) {
+    sccur.max += DELTASBIN;
+    sccur.cells = (SplitCache *)
+      memory->srealloc(sccur.cells,sccur.max*sizeof(SplitCache),
+                       "grid:splitcache");
+  }
+  bigint nd = (bigint) nsurf*nper + nsplitone;
+  while (sccur.nd + nd > sccur.maxd) {
+    sccur.maxd += DELTASBIN*nper;
+    memory->grow(sccur.dbuf,sccur.maxd,"grid:splitcache_dbuf");
+  }
+  if (nsplitone > 1) {
+    while (sccur.ni + nsurf > sccur.maxi) {
+      sccur.maxi += DELTASBIN;
+      memory->grow(sccur.ibuf,sccur.maxi,"grid:splitcache_ibuf");
+    }
+  }
+
+  SplitCache *sc = &sccur.cells[sccur.n++];
+  sc->id = cells[icell].id;
+  sc->nsurf = nsurf;
+  sc->nsplit = nsplitone;
+  sc->xsub = xsub;
+  sc->xsplit[0] = xsplit[0];
+  sc->xsplit[1] = xsplit[1];
+  sc->xsplit[2] = xsplit[2];
+  memcpy(sc->corner,cinfo[icell].corner,8*sizeof(int));
+  sc->doffset = sccur.nd;
+  sc->ioffset = sccur.ni;
+
+  surfint *csurfs = cells[icell].csurfs;
+  double *dbuf = &sccur.dbuf[sccur.nd];
+  int m = 0;
+
+  if (domain->dimension == 3) {
+    Surf::Tri *tris = surf->tris;
+    for (int i = 0; i < nsurf; i++) {
+      memcpy(&dbuf[m],tris[csurfs[i]].p1,3*sizeof(double));
+      memcpy(&dbuf[m+3],tris[csurfs[i]].p2,3*sizeof(double));
+      memcpy(&dbuf[m+6],tris[csurfs[i]].p3,3*sizeof(double));
+      dbuf[m+9] = tris[csurfs[i]].transparent;
+      m += 10;
+    }
+  } else {
+    Surf::Line *lines = surf->lines;
+    for (int i = 0; i < nsurf; i++) {
+      memcpy(&dbuf[m],lines[csurfs[i]].p1,3*sizeof(double));
+      memcpy(&dbuf[m+3],lines[csurfs[i]].p2,3*sizeof(double));
+      dbuf[m+6] = lines[csurfs[i]].transparent;
+      m += 7;
+    }
+  }
+
+  memcpy(&dbuf[m],vols,nsplitone*sizeof(double));
+  sccur.nd += nd;
+
+  if (nsplitone > 1) {
+    memcpy(&sccur.ibuf[sccur.ni],surfmap,nsurf*sizeof(int));
+    sccur.ni += nsurf;
+  }
+}
+
+/* ----------------------------------------------------------------------
+   cache built by this surf2grid_split() becomes cache for next call
+   cells not overlapped by surfs in this call are dropped
+------------------------------------------------------------------------- */
+
+void Grid::split_cache_swap()
+{
+  SplitCacheList tmp = scprev;
+  scprev = sccur;
+  sccur = tmp;
+  sccur.n = 0;
+  sccur.nd = sccur.ni = 0;
+
+  schash->clear();
+  for (int i = 0; i < scprev.n; i++) (*schash)[scprev.cells[i].id] = i;
+}
+
 /* ----------------------------------------------------------------------
    remove all surf info from owned grid cells and reset cell volumes
    also remove sub cells by compressing grid cells list
@@ -919,6 +1575,8 @@ void Grid::clear_surf()
   double *lo,*hi;
 
   hashfilled = 0;
+  nhcell = 0;
+  nsbincell = 0;
 
   // if surfs no longer exist, set cell type to OUTSIDE, else UNKNOWN
   // set corner points of every cell to UNKNOWN
@@ -1035,12 +1693,15 @@ void Grid::clear_surf_restart()
    combine all particles in sub cells of a split icell to be in split cell
    assumes particles are sorted, returns them sorted in icell
    if relabel = 1, also change icell value for each particle, else do not
+   particle cell lists can no longer be patched incrementally
 ------------------------------------------------------------------------- */
 
 void Grid::combine_split_cell_particles(int icell, int relabel)
 {
   int ip,iplast,jcell;
 
+  particle->incremental = 0;
+
   int nsplit = cells[icell].nsplit;
   int *mycsubs = sinfo[cells[icell].isplit].csubs;
   int count = 0;
@@ -1082,12 +1743,15 @@ void Grid::combine_split_cell_particles(int icell, int relabel)
    assign all particles in a split icell to appropriate sub cells
    assumes particles are sorted, are NOT sorted by sub cell when done
    also change particle icell label
+   particle cell lists can no longer be patched incrementally
 ------------------------------------------------------------------------- */
 
 void Grid::assign_split_cell_particles(int icell)
 {
   int ip,jcell;
 
+  particle->incremental = 0;
+
   int dim = domain->dimension;
   Particle::OnePart *particles = particle->particles;
   int *next = particle->next;
@@ -1383,7 +2047,7 @@ int Grid::rendezvous_surfrequest(int n, char *inbuf, int &flag,
    called by surf2grid_surf_algorithm()
 ------------------------------------------------------------------------- */
 
-int Grid::find_overlaps(int isurf, cellint *list)
+int Grid::find_overlaps(int isurf, cellint *list, Cut3d *cut3d, Cut2d *cut2d)
 {
   double slo[3],shi[3];
 
@@ -1399,14 +2063,13 @@ int Grid::find_overlaps(int isurf, cellint *list)
     shi[0] = MAX(line->p1[0],line->p2[0]);
     shi[1] = MAX(line->p1[1],line->p2[1]);
     
-    recurse2d(isurf,slo,shi,0,ncell,list);
+    recurse2d(isurf,slo,shi,0,ncell,list,cut2d);
 
   } else {
     Surf::Tri *tri;
     if (surf->distributed) tri = &surf->mytris[isurf];
     else tri = &surf->tris[isurf];
 
-    double sbox[2][3];
     slo[0] = MIN(tri->p1[0],tri->p2[0]);
     slo[0] = MIN(tri->p3[0],slo[0]);
     slo[1] = MIN(tri->p1[1],tri->p2[1]);
@@ -1421,7 +2084,7 @@ int Grid::find_overlaps(int isurf, cellint *list)
     shi[2] = MAX(tri->p1[2],tri->p2[2]);
     shi[2] = MAX(tri->p3[2],shi[2]);
     
-    recurse3d(isurf,slo,shi,0,ncell,list);
+    recurse3d(isurf,slo,shi,0,ncell,list,cut3d);
   }
 
   return ncell;
@@ -1438,13 +2101,14 @@ int Grid::find_overlaps(int isurf, cellint *list)
 ------------------------------------------------------------------------- */
 
 void Grid::recurse2d(int iline, double *slo, double *shi, int iparent, 
-                     int &n, cellint *list)
+                     int &n, cellint *list, Cut2d *cut2d)
 {
   int ix,iy,newparent,index,parentflag,overlap;
   cellint ichild,idchild;
   double celledge;
   double newslo[2],newshi[2];
   double clo[3],chi[3];
+  MyHash::iterator it;
 
   double *p1,*p2;
   if (surf->distributed) {
@@ -1456,8 +2120,8 @@ void Grid::recurse2d(int iline, double *slo, double *shi, int iparent,
   }
 
   ParentCell *p = &pcells[iparent];
-  double *plo = p->lo;
-  double *phi = p->hi;
+  double plo[3],phi[3];
+  parent_lohi(iparent,plo,phi);
   int nx = p->nx;
   int ny = p->ny;
 
@@ -1505,18 +2169,19 @@ void Grid::recurse2d(int iline, double *slo, double *shi, int iparent,
       idchild = p->id | (ichild << p->nbits);
       grid->id_child_lohi(iparent,ichild,clo,chi);
 
-      if (hash->find(idchild) == hash->end()) parentflag = 0;
-      else if ((*hash)[idchild] >= 0) parentflag = 0;
+      it = hash->find(idchild);
+      if (it == hash->end()) parentflag = 0;
+      else if (it->second >= 0) parentflag = 0;
       else parentflag = 1;
       
       if (parentflag) {
-        index = (*hash)[idchild];
+        index = it->second;
         newparent = -index-1;
         newslo[0] = MAX(slo[0],clo[0]);
         newslo[1] = MAX(slo[1],clo[1]);
         newshi[0] = MIN(shi[0],chi[0]);
         newshi[1] = MIN(shi[1],chi[1]);
-        recurse2d(iline,newslo,newshi,newparent,n,list);
+        recurse2d(iline,newslo,newshi,newparent,n,list,cut2d);
       } else { 
         overlap = cut2d->surf2grid_one(p1,p2,clo,chi);
         if (!overlap) continue;
@@ -1534,17 +2199,18 @@ void Grid::recurse2d(int iline, double *slo, double *shi, int iparent,
    slo/shi = bounding box around triangle
    iparent = current parent cell
    n, list = growing list of cell IDs this tri overlaps with
-   cut2d->surf2grid_one() is used to determine actual overlap
+   cut3d->surf2grid_one() is used to determine actual overlap
 ------------------------------------------------------------------------- */
 
 void Grid::recurse3d(int itri, double *slo, double *shi, int iparent, 
-                     int &n, cellint *list)
+                     int &n, cellint *list, Cut3d *cut3d)
 {
   int ix,iy,iz,newparent,index,parentflag,overlap;
   cellint ichild,idchild;
   double celledge;
   double newslo[3],newshi[3];
   double clo[3],chi[3];
+  MyHash::iterator it;
 
   double *p1,*p2,*p3;
   if (surf->distributed) {
@@ -1558,8 +2224,8 @@ void Grid::recurse3d(int itri, double *slo, double *shi, int iparent,
   }
 
   ParentCell *p = &pcells[iparent];
-  double *plo = p->lo;
-  double *phi = p->hi;
+  double plo[3],phi[3];
+  parent_lohi(iparent,plo,phi);
   int nx = p->nx;
   int ny = p->ny;
   int nz = p->nz;
@@ -1620,12 +2286,13 @@ void Grid::recurse3d(int itri, double *slo, double *shi, int iparent,
         idchild = p->id | (ichild << p->nbits);
         grid->id_child_lohi(iparent,ichild,clo,chi);
 
-        if (hash->find(idchild) == hash->end()) parentflag = 0;
-        else if ((*hash)[idchild] >= 0) parentflag = 0;
+        it = hash->find(idchild);
+        if (it == hash->end()) parentflag = 0;
+        else if (it->second >= 0) parentflag = 0;
         else parentflag = 1;
       
         if (parentflag) {
-          index = (*hash)[idchild];
+          index = it->second;
           newparent = -index-1;
           newslo[0] = MAX(slo[0],clo[0]);
           newslo[1] = MAX(slo[1],clo[1]);
@@ -1633,7 +2300,7 @@ void Grid::recurse3d(int itri, double *slo, double *shi, int iparent,
           newshi[0] = MIN(shi[0],chi[0]);
           newshi[1] = MIN(shi[1],chi[1]);
           newshi[2] = MIN(shi[2],chi[2]);
-          recurse3d(itri,newslo,newshi,newparent,n,list);
+          recurse3d(itri,newslo,newshi,newparent,n,list,cut3d);
         } else { 
           overlap = cut3d->surf2grid_one(p1,p2,p3,clo,chi);
           if (!overlap) continue;
@@ -1900,3 +2567,156 @@ double Grid::flow_volume()
 
   return volall;
 }
+
+/* ----------------------------------------------------------------------
+   bin csurfs of each owned and ghost cell with >= surfbin surfs
+   bins are a uniform sub-grid of the cell with ~SBINSURF surfs per bin
+   each surf is listed in every bin its bbox overlaps,
+     bbox is padded by EPSSBIN of cell size so that round-off in
+     the intersection tests in Update::move() cannot hit a culled surf
+   sub cells share the bins of their split cell
+   not done for axisymmetric, since particle paths are not straight lines
+   called from acquire_ghosts() and when global surfbin is set
+------------------------------------------------------------------------- */
+
+void Grid::surf_bins()
+{
+  int i,m,n,nb,nbins,ibin,ix,iy,iz,jcell;
+  double eps[3],plo[3],phi[3];
+  double *lo,*hi,*p1,*p2,*p3;
+  int *start;
+  surfint *ptr;
+  unsigned char *box;
+  SurfBin *sb;
+
+  nsbincell = 0;
+  if (!surf->exist || domain->axisymmetric) return;
+
+  int dim = domain->dimension;
+  Surf::Line *lines = surf->lines;
+  Surf::Tri *tris = surf->tris;
+
+  int nall = nlocal + nghost;
+  if (nall > maxsbincell) {
+    maxsbincell = nall;
+    memory->destroy(sbincell);
+    memory->create(sbincell,maxsbincell,"grid:sbincell");
+  }
+
+  int nsb = 0;
+  int nstart = 0;
+  int nlist = 0;
+  int nbox = 0;
+
+  for (int icell = 0; icell < nall; icell++) {
+    sbincell[icell] = -1;
+    n = cells[icell].nsurf;
+    if (n < surfbin) continue;
+
+    if (cells[icell].nsplit <= 0) {
+      jcell = sinfo[cells[icell].isplit].icell;
+      if (jcell < icell) {
+        sbincell[icell] = sbincell[jcell];
+        continue;
+      }
+    }
+
+    if (dim == 3) nb = static_cast<int> (ceil(pow(1.0*n/SBINSURF,1.0/3.0)));
+    else nb = static_cast<int> (ceil(sqrt(1.0*n/SBINSURF)));
+    nb = MIN(nb,MAXSBIN);
+    if (nb <= 1) continue;
+
+    if (nsb == maxsbin) {
+      maxsbin += DELTASBIN;
+      sbins = (SurfBin *)
+        memory->srealloc(sbins,maxsbin*sizeof(SurfBin),"grid:sbins");
+    }
+
+    sb = &sbins[nsb];
+    lo = cells[icell].lo;
+    hi = cells[icell].hi;
+    for (i = 0; i < 3; i++) {
+      if (i < dim) {
+        sb->nbin[i] = nb;
+        sb->lo[i] = lo[i];
+        sb->binv[i] = nb / (hi[i]-lo[i]);
+        eps[i] = EPSSBIN * (hi[i]-lo[i]);
+      } else {
+        sb->nbin[i] = 1;
+        sb->lo[i] = 0.0;
+        sb->binv[i] = 0.0;
+        eps[i] = 0.0;
+      }
+    }
+    nbins = sb->nbin[0] * sb->nbin[1] * sb->nbin[2];
+    sb->offset = nstart;
+    sb->boxoffset = nbox;
+
+    if (nstart+nbins+1 > maxsbinstart) {
+      maxsbinstart = nstart+nbins+1 + DELTASBIN;
+      memory->grow(sbinstart,maxsbinstart,"grid:sbinstart");
+    }
+    if (nbox+6*n > maxsbinbox) {
+      maxsbinbox = nbox+6*n + DELTASBIN;
+      memory->grow(sbinbox,maxsbinbox,"grid:sbinbox");
+    }
+
+    // bin range of padded bbox of each surf
+    // start[ibin+1] = # of surfs in bin ibin
+
+    start = &sbinstart[nstart];
+    for (ibin = 0; ibin <= nbins; ibin++) start[ibin] = 0;
+
+    ptr = cells[icell].csurfs;
+    for (m = 0; m < n; m++) {
+      if (dim == 3) {
+        p1 = tris[ptr[m]].p1;
+        p2 = tris[ptr[m]].p2;
+        p3 = tris[ptr[m]].p3;
+      } else {
+        p1 = lines[ptr[m]].p1;
+        p2 = p3 = lines[ptr[m]].p2;
+      }
+      box = &sbinbox[nbox+6*m];
+      for (i = 0; i < 3; i++) {
+        plo[i] = MIN(MIN(p1[i],p2[i]),p3[i]) - eps[i];
+        phi[i] = MAX(MAX(p1[i],p2[i]),p3[i]) + eps[i];
+        box[2*i] = sbin_coord(sb,i,plo[i]);
+        box[2*i+1] = sbin_coord(sb,i,phi[i]);
+      }
+      for (iz = box[4]; iz <= box[5]; iz++)
+        for (iy = box[2]; iy <= box[3]; iy++)
+          for (ix = box[0]; ix <= box[1]; ix++)
+            start[(iz*sb->nbin[1] + iy)*sb->nbin[0] + ix + 1]++;
+    }
+
+    // convert counts to offsets, fill lists in ascending surf order
+    // filling advances start[ibin] to end of bin, then shift back
+
+    start[0] = nlist;
+    for (ibin = 0; ibin < nbins; ibin++) start[ibin+1] += start[ibin];
+
+    if (start[nbins] > maxsbinlist) {
+      maxsbinlist = start[nbins] + DELTASBIN;
+      memory->grow(sbinlist,maxsbinlist,"grid:sbinlist");
+    }
+
+    for (m = 0; m < n; m++) {
+      box = &sbinbox[nbox+6*m];
+      for (iz = box[4]; iz <= box[5]; iz++)
+        for (iy = box[2]; iy <= box[3]; iy++)
+          for (ix = box[0]; ix <= box[1]; ix++)
+            sbinlist[start[(iz*sb->nbin[1] + iy)*sb->nbin[0] + ix]++] = m;
+    }
+
+    for (ibin = nbins-1; ibin > 0; ibin--) start[ibin] = start[ibin-1];
+    start[0] = nlist;
+
+    nlist = start[nbins];
+    nstart += nbins+1;
+    nbox += 6*n;
+    sbincell[icell] = nsb++;
+  }
+
+  nsbincell = nall;
+}
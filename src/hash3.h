@@ -13,6 +13,7 @@
 ------------------------------------------------------------------------- */
 
 // choose map or hash based on compilation flag
+// default for hashes with cellint keys is the open-addressing FlatHash
 
 #ifdef SPARTA_MAP
 #include <map>
@@ -20,4 +21,5 @@
 #include <unordered_map>
 #else
 #include <tr1/unordered_map>
+#include "flat_hash.h"
 #endif
@@ -35,6 +35,13 @@ int compare_standalone(const void *, const void *);
 #define BUFMIN 1000
 #define BUFEXTRA 1000
 
+// tags 0 and 1 are used by blocking exchanges in this file and others
+// pipelined chunks can arrive while a neighbor is in one of those,
+//   so PIPETAG must not be matched by their MPI_ANY_SOURCE receives
+
+#define COUNTTAG 2
+#define PIPETAG 3
+
 /* ---------------------------------------------------------------------- */
 
 Irregular::Irregular(SPARTA *sparta) : Pointers(sparta)
@@ -68,6 +75,19 @@ Irregular::Irregular(SPARTA *sparta) : Pointers(sparta)
   bufmax = 0;
   buf = NULL;
 
+  pipe_nchunk = pipe_ichunk = 0;
+  pipe_maxchunk = pipe_maxrequest = pipe_maxmsg = 0;
+  pipe_buf = NULL;
+  pipe_bufmax = NULL;
+  pipe_request = NULL;
+  pipe_count = pipe_offset = NULL;
+  memory->create(pipe_nrecvchunk,nprocs,"irregular:pipe_nrecvchunk");
+  pipe_rbuf = NULL;
+  pipe_rbufmax = pipe_rbufsize = 0;
+
+  npersist = 0;
+  persist_request = new MPI_Request[2*nprocs];
+
   copymode = 0;
 }
 
@@ -92,6 +112,18 @@ Irregular::~Irregular()
   memory->destroy(index_self);
   memory->destroy(offset_send);
   memory->destroy(buf);
+
+  for (int i = 0; i < pipe_maxchunk; i++) memory->destroy(pipe_buf[i]);
+  memory->sfree(pipe_buf);
+  memory->destroy(pipe_bufmax);
+  delete [] pipe_request;
+  memory->destroy(pipe_count);
+  memory->destroy(pipe_offset);
+  memory->destroy(pipe_nrecvchunk);
+  memory->destroy(pipe_rbuf);
+
+  persist_free();
+  delete [] persist_request;
 }
 
 /* ----------------------------------------------------------------------
@@ -204,6 +236,10 @@ void Irregular::create_procs(int n, int *proclist, int sort)
 
   for (i = 0; i < nrecv; i++) proc2recv[proc_recv[i]] = i;
 
+  // persistent requests for datum counts sent by augment_data_uniform()
+
+  persist_create();
+
   // barrier to insure all MPI_ANY_SOURCE messages are received
   // else another proc could proceed to augment_data() and send to me
 
@@ -721,36 +757,66 @@ int Irregular::augment_data_uniform(int n, int *proclist)
     }
   }
 
-  // tell receivers how many datums I send them
-  // sendmax = largest # of datums I send in a single message
+  // exchange datum counts with procs of plan via persistent requests
 
-  sendmax = 0;
-  for (i = 0; i < nsend; i++) {
-    MPI_Send(&num_send[i],1,MPI_INT,proc_send[i],0,world);
-    sendmax = MAX(sendmax,num_send[i]);
-  }
+  augment_counts();
 
-  // receive incoming messages
-  // num_recv = # of datums each proc sends me
-  // nrecvdatum = total # of datums I recv
+  // return # of datums I will receive
 
-  nrecvdatum = 0;
-  for (i = 0; i < nrecv; i++) {
-    MPI_Recv(&m,1,MPI_INT,MPI_ANY_SOURCE,0,world,status);
-    iproc = status->MPI_SOURCE;
-    num_recv[proc2recv[iproc]] = m;
-    nrecvdatum += m;
-  }
-  nrecvdatum += num_self;
+  return nrecvdatum;
+}
 
-  // barrier to insure all MPI_ANY_SOURCE messages are received
-  // else another proc could proceed to exchange_data() and send to me
+/* ----------------------------------------------------------------------
+   create persistent requests for datum counts, using procs of current plan
+   recvs are listed first, each into its slot of num_recv
+------------------------------------------------------------------------- */
 
-  MPI_Barrier(world);
+void Irregular::persist_create()
+{
+  persist_free();
 
-  // return # of datums I will receive
+  for (int irecv = 0; irecv < nrecv; irecv++)
+    MPI_Recv_init(&num_recv[irecv],1,MPI_INT,proc_recv[irecv],COUNTTAG,world,
+                  &persist_request[irecv]);
+  for (int isend = 0; isend < nsend; isend++)
+    MPI_Send_init(&num_send[isend],1,MPI_INT,proc_send[isend],COUNTTAG,world,
+                  &persist_request[nrecv+isend]);
 
-  return nrecvdatum;
+  npersist = nrecv + nsend;
+}
+
+/* ----------------------------------------------------------------------
+   free persistent requests, all are inactive between exchanges
+------------------------------------------------------------------------- */
+
+void Irregular::persist_free()
+{
+  for (int i = 0; i < npersist; i++) MPI_Request_free(&persist_request[i]);
+  npersist = 0;
+}
+
+/* ----------------------------------------------------------------------
+   send num_send to each proc I send to, recv num_recv from each I recv from
+   sets sendmax = largest # of datums I send in a single message
+   sets nrecvdatum = total # of datums I recv, including from self
+   recvs are matched by proc, not by arrival, and counts use their own tag,
+     so a proc already in its next exchange cannot be mistaken for this one
+------------------------------------------------------------------------- */
+
+void Irregular::augment_counts()
+{
+  int i;
+
+  sendmax = 0;
+  for (i = 0; i < nsend; i++) sendmax = MAX(sendmax,num_send[i]);
+
+  if (npersist) {
+    MPI_Startall(npersist,persist_request);
+    MPI_Waitall(npersist,persist_request,MPI_STATUSES_IGNORE);
+  }
+
+  nrecvdatum = num_self;
+  for (i = 0; i < nrecv; i++) nrecvdatum += num_recv[i];
 }
 
 /* ----------------------------------------------------------------------
@@ -904,3 +970,193 @@ void Irregular::reverse(int n, int *proclist)
     for (int j = 0; j < num_recv[i]; j++) proclist[m++] = proc;
   }
 }
+
+/* ----------------------------------------------------------------------
+   start a pipelined exchange of uniform-size datums
+   uses procs I send to and recv from in plan set up by create_procs()
+   nchunk = # of times pipe_send() will be called, same on all procs
+   nbytes = size of each datum
+   datums are sent with non-blocking sends as each chunk is ready,
+     so comm overlaps with the caller producing the next chunk
+   datums are received in any order, but pipe_unpack() returns them
+     in same order as exchange_uniform() would for all chunks at once
+------------------------------------------------------------------------- */
+
+void Irregular::pipe_start(int nchunk, int nbytes)
+{
+  if (nchunk > pipe_maxchunk) {
+    pipe_buf = (char **)
+      memory->srealloc(pipe_buf,nchunk*sizeof(char *),"irregular:pipe_buf");
+    memory->grow(pipe_bufmax,nchunk,"irregular:pipe_bufmax");
+    for (int i = pipe_maxchunk; i < nchunk; i++) {
+      pipe_buf[i] = NULL;
+      pipe_bufmax[i] = 0;
+    }
+    pipe_maxchunk = nchunk;
+  }
+
+  if (nchunk*nsend > pipe_maxrequest) {
+    delete [] pipe_request;
+    pipe_maxrequest = nchunk*nsend;
+    pipe_request = new MPI_Request[pipe_maxrequest];
+  }
+
+  if (nchunk*nrecv > pipe_maxmsg) {
+    pipe_maxmsg = nchunk*nrecv;
+    memory->destroy(pipe_count);
+    memory->destroy(pipe_offset);
+    memory->create(pipe_count,pipe_maxmsg,"irregular:pipe_count");
+    memory->create(pipe_offset,pipe_maxmsg,"irregular:pipe_offset");
+  }
+
+  for (int i = 0; i < nrecv; i++) pipe_nrecvchunk[i] = 0;
+
+  pipe_nchunk = nchunk;
+  pipe_ichunk = 0;
+  pipe_nbytes = nbytes;
+  pipe_rbufsize = 0;
+}
+
+/* ----------------------------------------------------------------------
+   send next chunk of datums, one message to every proc I send to
+   n = # of datums in chunk
+   proclist = proc to send each datum to, cannot be self
+   sendbuf = datums, copied so caller can reuse it once this returns
+------------------------------------------------------------------------- */
+
+void Irregular::pipe_send(int n, int *proclist, char *sendbuf)
+{
+  int i,isend,offset;
+
+  int ichunk = pipe_ichunk++;
+  int nbytes = pipe_nbytes;
+
+  for (isend = 0; isend < nsend; isend++) num_send[isend] = 0;
+  for (i = 0; i < n; i++) {
+    if (proclist[i] == me)
+      error->one(FLERR,"Irregular pipelined comm cannot send to self");
+    num_send[work1[proclist[i]]]++;
+  }
+
+  if (n*nbytes > pipe_bufmax[ichunk]) {
+    pipe_bufmax[ichunk] = n*nbytes;
+    memory->destroy(pipe_buf[ichunk]);
+    memory->create(pipe_buf[ichunk],pipe_bufmax[ichunk],"irregular:pipe_buf");
+  }
+  char *cbuf = pipe_buf[ichunk];
+
+  // work2 = byte offset in cbuf of message to each proc I send to
+  // copy datums in order so each message keeps order of sendbuf
+
+  offset = 0;
+  for (isend = 0; isend < nsend; isend++) {
+    work2[isend] = offset;
+    offset += num_send[isend]*nbytes;
+  }
+
+  for (i = 0; i < n; i++) {
+    isend = work1[proclist[i]];
+    memcpy(&cbuf[work2[isend]],&sendbuf[i*nbytes],nbytes);
+    work2[isend] += nbytes;
+  }
+
+  offset = 0;
+  MPI_Request *req = &pipe_request[ichunk*nsend];
+  for (isend = 0; isend < nsend; isend++) {
+    MPI_Isend(&cbuf[offset],num_send[isend]*nbytes,MPI_CHAR,
+              proc_send[isend],PIPETAG,world,&req[isend]);
+    offset += num_send[isend]*nbytes;
+  }
+
+  pipe_poll();
+}
+
+/* ----------------------------------------------------------------------
+   receive any messages that have already arrived, without blocking
+   only called by pipe_send(), so once per chunk
+   probe each proc separately and take exactly nchunk messages from it,
+     messages from one proc are not overtaking, so a proc that is
+     already in its next exchange cannot be mistaken for this one
+------------------------------------------------------------------------- */
+
+void Irregular::pipe_poll()
+{
+  int flag;
+  MPI_Status mpistatus;
+
+  for (int irecv = 0; irecv < nrecv; irecv++)
+    while (pipe_nrecvchunk[irecv] < pipe_nchunk) {
+      MPI_Iprobe(proc_recv[irecv],PIPETAG,world,&flag,&mpistatus);
+      if (!flag) break;
+      pipe_recv(&mpistatus);
+    }
+}
+
+/* ----------------------------------------------------------------------
+   receive one message that has been probed
+   append it to pipe_rbuf and record its chunk and size
+------------------------------------------------------------------------- */
+
+void Irregular::pipe_recv(MPI_Status *mpistatus)
+{
+  int nbytes;
+  MPI_Get_count(mpistatus,MPI_CHAR,&nbytes);
+  int iproc = mpistatus->MPI_SOURCE;
+  int irecv = proc2recv[iproc];
+
+  if ((bigint) pipe_rbufsize + nbytes > MAXSMALLINT)
+    error->one(FLERR,"Irregular comm recv buffer exceeds 2 GB");
+  if (pipe_rbufsize + nbytes > pipe_rbufmax) {
+    pipe_rbufmax = static_cast<int> 
+      (MIN(BUFFACTOR*(pipe_rbufsize+nbytes) + BUFEXTRA,MAXSMALLINT));
+    memory->grow(pipe_rbuf,pipe_rbufmax,"irregular:pipe_rbuf");
+  }
+
+  MPI_Recv(&pipe_rbuf[pipe_rbufsize],nbytes,MPI_CHAR,iproc,PIPETAG,world,
+           MPI_STATUS_IGNORE);
+
+  int m = irecv*pipe_nchunk + pipe_nrecvchunk[irecv]++;
+  pipe_count[m] = nbytes/pipe_nbytes;
+  pipe_offset[m] = pipe_rbufsize;
+  pipe_rbufsize += nbytes;
+}
+
+/* ----------------------------------------------------------------------
+   wait until all messages are received and all sends are complete
+   return total # of datums I recv
+------------------------------------------------------------------------- */
+
+int Irregular::pipe_wait()
+{
+  MPI_Status mpistatus;
+
+  for (int irecv = 0; irecv < nrecv; irecv++)
+    while (pipe_nrecvchunk[irecv] < pipe_nchunk) {
+      MPI_Probe(proc_recv[irecv],PIPETAG,world,&mpistatus);
+      pipe_recv(&mpistatus);
+    }
+
+  if (pipe_ichunk && nsend)
+    MPI_Waitall(pipe_ichunk*nsend,pipe_request,MPI_STATUSES_IGNORE);
+
+  return pipe_rbufsize/pipe_nbytes;
+}
+
+/* ----------------------------------------------------------------------
+   copy received datums to recvbuf
+   ordered by recv proc, then by chunk, same as exchange_uniform()
+------------------------------------------------------------------------- */
+
+void Irregular::pipe_unpack(char *recvbuf)
+{
+  int m,nbytes;
+
+  int offset = 0;
+  for (int irecv = 0; irecv < nrecv; irecv++)
+    for (int ichunk = 0; ichunk < pipe_nchunk; ichunk++) {
+      m = irecv*pipe_nchunk + ichunk;
+      nbytes = pipe_count[m]*pipe_nbytes;
+      memcpy(&recvbuf[offset],&pipe_rbuf[pipe_offset[m]],nbytes);
+      offset += nbytes;
+    }
+}
@@ -37,6 +37,12 @@ class Irregular : protected Pointers {
   void exchange_variable(char *, int *, char *);
   void reverse(int, int *);
 
+  void pipe_start(int, int);
+  void pipe_send(int, int *, char *);
+  void pipe_poll();
+  int pipe_wait();
+  void pipe_unpack(char *);
+
  protected:
   int me,nprocs;
 
@@ -73,6 +79,39 @@ class Irregular : protected Pointers {
   int *size_send;            // # of bytes of send to each proc
   int *size_recv;            // # of bytes to recv from each proc
   int *offset_send;          // list of byte offsets for each send datum
+
+  // only defined for pipelined exchange of uniform datums
+  // uses procs of plan from create_procs(), one message per proc per chunk
+  // the Kth message from a proc is its Kth chunk, since MPI preserves order
+
+  int pipe_nchunk;           // # of chunks in current exchange
+  int pipe_ichunk;           // # of chunks sent so far
+  int pipe_nbytes;           // size of each datum
+  int pipe_maxchunk;         // length of pipe_buf and pipe_bufmax
+  char **pipe_buf;           // send buffer for each chunk
+  int *pipe_bufmax;          // size of each send buffer in bytes
+  int pipe_maxrequest;       // length of pipe_request
+  MPI_Request *pipe_request; // requests for posted sends of all chunks
+  int pipe_maxmsg;           // length of pipe_count and pipe_offset
+  int *pipe_count;           // # of datums in each message, nrecv x nchunk
+  int *pipe_offset;          // byte offset of each message in pipe_rbuf
+  int *pipe_nrecvchunk;      // # of chunks received so far from each proc
+  char *pipe_rbuf;           // received messages in order of arrival
+  int pipe_rbufmax;          // size of pipe_rbuf in bytes
+  int pipe_rbufsize;         // bytes in pipe_rbuf
+
+  void pipe_recv(MPI_Status *);
+
+  // persistent requests for exchanging datum counts in augment_data_uniform()
+  // built once by create_procs(), since its procs are fixed until next call
+  // recvs from known procs, so no MPI_ANY_SOURCE and no barrier per exchange
+
+  int npersist;              // # of persistent requests = nrecv + nsend
+  MPI_Request *persist_request; // recvs into num_recv, then sends of num_send
+
+  void persist_create();
+  void persist_free();
+  void augment_counts();
 };
 
 }
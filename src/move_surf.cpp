@@ -34,6 +34,7 @@ enum{READFILE,TRANSLATE,ROTATE};
 enum{UNKNOWN,OUTSIDE,INSIDE,OVERLAP};           // several files
 
 #define MAXLINE 256
+#define BIG 1.0e20
 
 /* ---------------------------------------------------------------------- */
 
@@ -51,6 +52,7 @@ MoveSurf::MoveSurf(SPARTA *sparta) : Pointers(sparta)
 
   file = NULL;
   fp = NULL;
+  sweptflag = 0;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -126,8 +128,17 @@ void MoveSurf::command(int narg, char **arg)
 	grid->combine_split_cell_particles(icell,1);
   }
 
-  grid->clear_surf();
-  grid->surf2grid(1);
+  // if sweptflag, only re-map surfs in cells overlapping swept bbox
+
+  if (sweptflag) grid->surf2grid_swept(sweptlo,swepthi,1);
+  else {
+    grid->clear_surf();
+    grid->surf2grid(1);
+  }
+
+  // split and sub cells were rebuilt, so particle cell lists must be too
+
+  particle->incremental = 0;
 
   if (dim == 2) surf->check_point_near_surf_2d();
   else surf->check_point_near_surf_3d();
@@ -139,6 +150,7 @@ void MoveSurf::command(int narg, char **arg)
   double time3 = MPI_Wtime();
 
   // re-setup owned and ghost cell info
+  // done for all cells, even if sweptflag
 
   grid->setup_owned();
   grid->acquire_ghosts();
@@ -245,6 +257,7 @@ void MoveSurf::process_args(int narg, char **arg)
   // optional args
 
   connectflag = 0;
+  sweptflag = 0;
 
   while (iarg < narg) {
     if (strcmp(arg[iarg],"connect") == 0) {
@@ -252,6 +265,12 @@ void MoveSurf::process_args(int narg, char **arg)
       if (strcmp(arg[iarg+1],"yes") == 0) connectflag = 1;
       else if (strcmp(arg[iarg+1],"no") == 0) connectflag = 0;
       iarg += 2;
+    } else if (strcmp(arg[iarg],"local") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal move surf command");
+      if (strcmp(arg[iarg+1],"yes") == 0) sweptflag = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) sweptflag = 0;
+      else error->all(FLERR,"Illegal move surf command");
+      iarg += 2;
     } else error->all(FLERR,"Illegal move surf command");
   }
 }
@@ -264,6 +283,7 @@ void MoveSurf::process_args(int narg, char **arg)
 
 void MoveSurf::move_lines(double fraction, Surf::Line *origlines)
 {
+  if (sweptflag) swept_bbox(0);
   if (connectflag && groupbit != 1) connect_2d_pre();
 
   if (action == READFILE) {
@@ -275,6 +295,8 @@ void MoveSurf::move_lines(double fraction, Surf::Line *origlines)
   
   if (connectflag && groupbit != 1) connect_2d_post();
 
+  if (sweptflag) swept_bbox(1);
+
   surf->compute_line_normal(0);
 
   // check that all points are still inside simulation box
@@ -290,6 +312,7 @@ void MoveSurf::move_lines(double fraction, Surf::Line *origlines)
 
 void MoveSurf::move_tris(double fraction, Surf::Tri *origtris)
 {
+  if (sweptflag) swept_bbox(0);
   if (connectflag && groupbit != 1) connect_3d_pre();
 
   if (action == READFILE) {
@@ -301,6 +324,8 @@ void MoveSurf::move_tris(double fraction, Surf::Tri *origtris)
 
   if (connectflag && groupbit != 1) connect_3d_post();
 
+  if (sweptflag) swept_bbox(1);
+
   surf->compute_tri_normal(0);
 
   // check that all points are still inside simulation box
@@ -808,6 +833,68 @@ void MoveSurf::connect_3d_post()
   delete hash;
 }
 
+/* ----------------------------------------------------------------------
+   bounding box of moved surfs in sweptlo/swepthi
+   flag = 0: before move, init box to surfs in group at old positions
+   flag = 1: after move, extend box by surfs with a moved point,
+     includes surfs not in group that are moved via connectflag,
+     their unmoved points are in box b/c they are shared with group surfs
+   in 2d, box spans z extent of simulation box
+------------------------------------------------------------------------- */
+
+void MoveSurf::swept_bbox(int flag)
+{
+  int i,j;
+  double *p[3];
+
+  dim = domain->dimension;
+  int nsurf = surf->nsurf;
+  int npoint = dim;
+
+  if (flag == 0) {
+    sweptlo[0] = sweptlo[1] = sweptlo[2] = BIG;
+    swepthi[0] = swepthi[1] = swepthi[2] = -BIG;
+  }
+
+  for (i = 0; i < nsurf; i++) {
+    if (dim == 2) {
+      if (flag == 0 && !(surf->lines[i].mask & groupbit)) continue;
+      if (flag == 1 && !pselect[2*i] && !pselect[2*i+1]) continue;
+      p[0] = surf->lines[i].p1;
+      p[1] = surf->lines[i].p2;
+    } else {
+      if (flag == 0 && !(surf->tris[i].mask & groupbit)) continue;
+      if (flag == 1 && !pselect[3*i] && !pselect[3*i+1] && !pselect[3*i+2])
+        continue;
+      p[0] = surf->tris[i].p1;
+      p[1] = surf->tris[i].p2;
+      p[2] = surf->tris[i].p3;
+    }
+
+    for (int m = 0; m < npoint; m++)
+      for (j = 0; j < dim; j++) {
+        sweptlo[j] = MIN(sweptlo[j],p[m][j]);
+        swepthi[j] = MAX(swepthi[j],p[m][j]);
+      }
+  }
+
+  if (dim == 2) {
+    sweptlo[2] = domain->boxlo[2];
+    swepthi[2] = domain->boxhi[2];
+  }
+}
+
+/* ----------------------------------------------------------------------
+   return 1 if box lo/hi overlaps swept bbox, touching counts as overlap
+------------------------------------------------------------------------- */
+
+int MoveSurf::swept_overlap(double *lo, double *hi)
+{
+  for (int j = 0; j < dim; j++)
+    if (hi[j] < sweptlo[j] || lo[j] > swepthi[j]) return 0;
+  return 1;
+}
+
 /* ----------------------------------------------------------------------
    remove particles in any cell that is now INSIDE or contains moved surfs
    surfs that moved determined by pselect for any of its points
@@ -844,7 +931,10 @@ bigint MoveSurf::remove_particles()
     // if m < nsurf, loop over csurfs did not finish
     // which means cell contains a moved surf, so delete all its particles
 
-    if (cells[icell].nsurf && cells[icell].nsplit >= 1) {
+    // if sweptflag, cell outside swept bbox cannot contain a moved surf
+
+    if (cells[icell].nsurf && cells[icell].nsplit >= 1 && 
+        (!sweptflag || swept_overlap(cells[icell].lo,cells[icell].hi))) {
       nsurf = cells[icell].nsurf;
       csurfs = cells[icell].csurfs;
 
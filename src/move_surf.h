@@ -32,6 +32,8 @@ class MoveSurf : protected Pointers {
  public:
   int mode;                 // 0 = move_surf command, 1 = fix move/surf command
   int groupbit;             // FixMoveSurf sets surf group
+  int sweptflag;            // 1 if move_lines/tris() compute swept bbox
+  double sweptlo[3],swepthi[3];   // bbox of moved surfs, old + new positions
 
   // hash for surface element points
 
@@ -79,6 +81,8 @@ class MoveSurf : protected Pointers {
   void connect_2d_post();
   void connect_3d_pre();
   void connect_3d_post();
+  void swept_bbox(int);
+  int swept_overlap(double *, double *);
 };
 
 }
@@ -51,7 +51,7 @@ Particle::Particle(SPARTA *sparta) : Pointers(sparta)
 {
   MPI_Comm_rank(world,&me);
 
-  exist = sorted = 0;
+  exist = sorted = contiguous = 0;
   nglobal = 0;
   nlocal = maxlocal = 0;
   particles = NULL;
@@ -66,6 +66,14 @@ Particle::Particle(SPARTA *sparta) : Pointers(sparta)
   maxsort = 0;
   next = NULL;
 
+  incremental = 0;
+  ndirty = maxdirty = 0;
+  dirty = NULL;
+  maxlink = nlinked = nlow = 0;
+  prev = scell = NULL;
+  maxscratch = 0;
+  scratch = NULL;
+
   // create two default mixtures
 
   nmixture = maxmixture = 0;
@@ -119,6 +127,10 @@ Particle::~Particle()
   //memory->destroy(cellcount);
   //memory->destroy(first);
   memory->destroy(next);
+  memory->destroy(dirty);
+  memory->destroy(prev);
+  memory->destroy(scell);
+  memory->destroy(scratch);
 
   for (int i = 0; i < ncustom; i++) delete [] ename[i];
   memory->sfree(ename);
@@ -213,6 +225,7 @@ void Particle::init()
    this is similar to compress_reactions(), but does not need
      an auxiliary vector b/c indices are in ascending order
    this does NOT preserve particle sorting
+   if incremental, overwritten indices are added to dirty list
 ------------------------------------------------------------------------- */
 
 void Particle::compress_migrate(int nmigrate, int *mlist)
@@ -220,7 +233,25 @@ void Particle::compress_migrate(int nmigrate, int *mlist)
   int i,j,k;
   int nbytes = sizeof(OnePart);
 
-  if (!ncustom) {
+  if (incremental) {
+    for (i = 0; i < nmigrate; i++) {
+      j = mlist[i];
+      k = nlocal - 1;
+      while (k == mlist[nmigrate-1] && k > j) {
+        nmigrate--;
+        nlocal--;
+        k--;
+      }
+      nlocal--;
+      if (j == k) continue;
+      memcpy(&particles[j],&particles[k],nbytes);
+      if (ncustom) copy_custom(j,k);
+      if (ndirty == maxdirty) grow_dirty(ndirty+1);
+      dirty[ndirty++] = j;
+    }
+    nlow = MIN(nlow,nlocal);
+
+  } else if (!ncustom) {
     for (i = 0; i < nmigrate; i++) {
       j = mlist[i];
       k = nlocal - 1;
@@ -288,6 +319,7 @@ void Particle::compress_rebalance()
   }
 
   sorted = 0;
+  incremental = 0;
 }
 
 /* ----------------------------------------------------------------------
@@ -351,18 +383,21 @@ void Particle::compress_rebalance_sorted()
       } else i++;
     }
   }
+
+  incremental = 0;
 }
 
 /* ----------------------------------------------------------------------
    compress particle list to remove particles with indices in dellist
    dellist indices can be in ANY order
    overwrite deleted particle with particle from end of nlocal list
-   use of next vector does bookkeeping for particles
+   use of scratch vector does bookkeeping for particles
      that are moved from their original location before they are deleted
    called from Collide::migrate_particles() each timestep
      if any particles were deleted by gas-phase collision reactions
    this is similar to compress_migrate(), but needs to use
      an auxiliary vector b/c indices are in random order
+   if incremental, overwritten indices are added to dirty list
 ------------------------------------------------------------------------- */
 
 void Particle::compress_reactions(int ndelete, int *dellist)
@@ -371,48 +406,58 @@ void Particle::compress_reactions(int ndelete, int *dellist)
 
   int nbytes = sizeof(OnePart);
 
-  // reallocate next list as needed
+  // reallocate scratch vector as needed
+  // not next, since sort_incremental() needs it preserved
 
-  if (maxsort < maxlocal) {
-    maxsort = maxlocal;
-    memory->destroy(next);
-    memory->create(next,maxsort,"particle:next");
+  if (maxscratch < ndelete) {
+    maxscratch = ndelete;
+    memory->destroy(scratch);
+    memory->create(scratch,maxscratch,"particle:scratch");
   }
 
-  // use next as a scratch vector
-  // is always defined when performing collisions and thus gas reactions
-  // next is only used for upper locs from nlocal-ndelete to nlocal
-  // next[i] = current index of atom originally at index i, when i >= nlocal
-  // next[i] = original index of atom currently at index i, when i <= nlocal
+  // scratch is only used for upper locs from nlocal-ndelete to nlocal
+  // so is indexed by i-upper
+  // scratch[i] = current index of atom originally at index i, when i >= nlocal
+  // scratch[i] = original index of atom currently at index i, when i <= nlocal
 
   int upper = nlocal-ndelete;
-  for (i = upper; i < nlocal; i++) next[i] = i;
+  for (i = upper; i < nlocal; i++) scratch[i-upper] = i;
 
   // i = current index of atom to remove, even if it previously moved
 
   if (!ncustom) {
     for (int m = 0; m < ndelete; m++) {
       i = dellist[m];
-      if (i >= nlocal) i = next[i];
+      if (i >= nlocal) i = scratch[i-upper];
       nlocal--;
       if (i == nlocal) continue;
       memcpy(&particles[i],&particles[nlocal],nbytes);
-      if (i >= upper) next[i] = next[nlocal];
-      next[next[nlocal]] = i;
+      if (i >= upper) scratch[i-upper] = scratch[nlocal-upper];
+      scratch[scratch[nlocal-upper]-upper] = i;
+      if (incremental) {
+        if (ndirty == maxdirty) grow_dirty(ndirty+1);
+        dirty[ndirty++] = i;
+      }
     }
 
   } else {
     for (int m = 0; m < ndelete; m++) {
       i = dellist[m];
-      if (i >= nlocal) i = next[i];
+      if (i >= nlocal) i = scratch[i-upper];
       nlocal--;
       if (i == nlocal) continue;
       memcpy(&particles[i],&particles[nlocal],nbytes);
       copy_custom(i,nlocal);
-      if (i >= upper) next[i] = next[nlocal];
-      next[next[nlocal]] = i;
+      if (i >= upper) scratch[i-upper] = scratch[nlocal-upper];
+      scratch[scratch[nlocal-upper]-upper] = i;
+      if (incremental) {
+        if (ndirty == maxdirty) grow_dirty(ndirty+1);
+        dirty[ndirty++] = i;
+      }
     }
   }
+
+  if (incremental) nlow = MIN(nlow,nlocal);
 }
 
 /* ----------------------------------------------------------------------
@@ -425,6 +470,8 @@ void Particle::compress_reactions(int ndelete, int *dellist)
 void Particle::sort()
 {
   sorted = 1;
+  contiguous = 0;
+  incremental = 0;
 
   // reallocate next list as needed
   // NOTE: why not just compare maxsort to nlocal?
@@ -468,6 +515,287 @@ void Particle::sort()
   }
 }
 
+/* ----------------------------------------------------------------------
+   sort particles into grid cells, patching lists from previous call
+   only re-link list indices in dirty list or beyond nlow,
+     which are the only ones whose icell can have changed
+   lists are doubly linked via next/prev so any index can be unlinked
+   scell[i] = cell that index i is currently linked into
+   if lists are not valid, e.g. grid changed or sort() was called,
+     rebuild them from scratch in same order as sort()
+   resulting order of particles within a cell differs from sort()
+   called from Update::run() if global particle/sort = incremental
+------------------------------------------------------------------------- */
+
+void Particle::sort_incremental()
+{
+  int i,m,icell,ip;
+
+  Grid::ChildInfo *cinfo = grid->cinfo;
+
+  // full rebuild, then prev/scell are also valid
+
+  if (!incremental) {
+    if (maxsort < maxlocal) {
+      maxsort = maxlocal;
+      memory->destroy(next);
+      memory->create(next,maxsort,"particle:next");
+    }
+    if (maxlink < maxlocal) {
+      maxlink = maxlocal;
+      memory->destroy(prev);
+      memory->destroy(scell);
+      memory->create(prev,maxlink,"particle:prev");
+      memory->create(scell,maxlink,"particle:scell");
+    }
+
+    int nglocal = grid->nlocal;
+    for (icell = 0; icell < nglocal; icell++) {
+      cinfo[icell].first = -1;
+      cinfo[icell].count = 0;
+    }
+
+    for (i = nlocal-1; i >= 0; i--) {
+      icell = particles[i].icell;
+      ip = cinfo[icell].first;
+      next[i] = ip;
+      prev[i] = -1;
+      if (ip >= 0) prev[ip] = i;
+      cinfo[icell].first = i;
+      cinfo[icell].count++;
+      scell[i] = icell;
+    }
+
+    incremental = 1;
+
+  } else {
+
+    // grow lists, preserving current links
+
+    if (maxsort < maxlocal) {
+      maxsort = maxlocal;
+      memory->grow(next,maxsort,"particle:next");
+    }
+    if (maxlink < maxlocal) {
+      maxlink = maxlocal;
+      memory->grow(prev,maxlink,"particle:prev");
+      memory->grow(scell,maxlink,"particle:scell");
+    }
+
+    // unlink indices no longer used, then re-link all that may have changed
+    // indices from nlinked to nlocal were never linked
+
+    for (i = nlocal; i < nlinked; i++) unlink(i);
+    for (i = nlinked; i < nlocal; i++) scell[i] = -1;
+
+    for (i = MIN(nlow,nlocal); i < nlocal; i++) relink(i);
+    for (m = 0; m < ndirty; m++) {
+      i = dirty[m];
+      if (i < nlocal) relink(i);
+    }
+  }
+
+  nlinked = nlow = nlocal;
+  ndirty = 0;
+  sorted = 1;
+  contiguous = 0;
+}
+
+/* ----------------------------------------------------------------------
+   remove list index I from the cell list it is linked into, if any
+------------------------------------------------------------------------- */
+
+void Particle::unlink(int i)
+{
+  int icell = scell[i];
+  if (icell < 0) return;
+
+  Grid::ChildInfo *cinfo = grid->cinfo;
+  if (prev[i] >= 0) next[prev[i]] = next[i];
+  else cinfo[icell].first = next[i];
+  if (next[i] >= 0) prev[next[i]] = prev[i];
+  cinfo[icell].count--;
+  scell[i] = -1;
+}
+
+/* ----------------------------------------------------------------------
+   move list index I to head of list for cell it is now in, if changed
+------------------------------------------------------------------------- */
+
+void Particle::relink(int i)
+{
+  int icell = particles[i].icell;
+  if (scell[i] == icell) return;
+  unlink(i);
+
+  Grid::ChildInfo *cinfo = grid->cinfo;
+  int ip = cinfo[icell].first;
+  next[i] = ip;
+  prev[i] = -1;
+  if (ip >= 0) prev[ip] = i;
+  cinfo[icell].first = i;
+  cinfo[icell].count++;
+  scell[i] = icell;
+}
+
+/* ----------------------------------------------------------------------
+   insure list of particle indices whose icell may have changed
+     can hold n indices
+------------------------------------------------------------------------- */
+
+void Particle::grow_dirty(int n)
+{
+  if (n <= maxdirty) return;
+  while (maxdirty < n) maxdirty += DELTA;
+  memory->grow(dirty,maxdirty,"particle:dirty");
+}
+
+/* ----------------------------------------------------------------------
+   reorder particles in memory so each grid cell owns a contiguous range
+   assumes particles are sorted, uses linked lists as a counting sort
+   permute[n] = old index of particle that moves to new index n
+   particles and custom attributes are permuted out-of-place,
+     unless mem/limit is set and too small for a 2nd copy of particles,
+     then permuted in-place by following cycles of the permutation
+   afterwards cinfo.first = start of range, next[i] = i+1 within a cell
+   called from Update::run() every reorder_period timesteps
+------------------------------------------------------------------------- */
+
+void Particle::reorder()
+{
+  int i,j,k,n,ip,icell;
+
+  if (!sorted) sort();
+  contiguous = 1;
+  incremental = 0;
+  if (nlocal == 0) return;
+
+  Grid::ChildInfo *cinfo = grid->cinfo;
+  int nglocal = grid->nlocal;
+
+  int *permute;
+  memory->create(permute,nlocal,"particle:permute");
+
+  n = 0;
+  for (icell = 0; icell < nglocal; icell++) {
+    ip = cinfo[icell].first;
+    while (ip >= 0) {
+      permute[n++] = ip;
+      ip = next[ip];
+    }
+  }
+
+  // inplace = 1 if extra memory for a 2nd copy of particles exceeds limit
+
+  if (update->mem_limit_grid_flag) update->set_mem_limit_grid();
+  int inplace = 0;
+  if (update->global_mem_limit > 0 &&
+      (bigint) nlocal * (bigint) sizeof(OnePart) >
+      (bigint) update->global_mem_limit)
+    inplace = 1;
+
+  int nbytes = sizeof(OnePart);
+
+  if (!inplace) {
+    OnePart *pnew = (OnePart *)
+      memory->smalloc((bigint) maxlocal*nbytes,"particle:particles");
+    for (n = 0; n < nlocal; n++)
+      memcpy(&pnew[n],&particles[permute[n]],nbytes);
+    memset(&pnew[nlocal],0,(bigint) (maxlocal-nlocal)*nbytes);
+    memory->sfree(particles);
+    particles = pnew;
+    if (ncustom) reorder_custom(permute);
+
+  // dest = next, so can follow each cycle of the permutation
+  // index nlocal is scratch space to hold one particle during a cycle
+
+  } else {
+    int *dest = next;
+    for (n = 0; n < nlocal; n++) dest[permute[n]] = n;
+    grow(1);
+
+    for (i = 0; i < nlocal; i++) {
+      if (dest[i] == i) continue;
+      memcpy(&particles[nlocal],&particles[i],nbytes);
+      if (ncustom) copy_custom(nlocal,i);
+      j = i;
+      while (permute[j] != i) {
+        k = permute[j];
+        memcpy(&particles[j],&particles[k],nbytes);
+        if (ncustom) copy_custom(j,k);
+        dest[j] = j;
+        j = k;
+      }
+      memcpy(&particles[j],&particles[nlocal],nbytes);
+      if (ncustom) copy_custom(j,nlocal);
+      dest[j] = j;
+    }
+  }
+
+  memory->destroy(permute);
+
+  // reset linked lists to match new contiguous ordering
+
+  n = 0;
+  for (icell = 0; icell < nglocal; icell++) {
+    if (cinfo[icell].count == 0) continue;
+    cinfo[icell].first = n;
+    n += cinfo[icell].count;
+    for (i = cinfo[icell].first; i < n-1; i++) next[i] = i+1;
+    next[n-1] = -1;
+  }
+}
+
+/* ----------------------------------------------------------------------
+   permute all custom vectors/arrays out-of-place
+   permute[n] = old index of particle that moves to new index n
+------------------------------------------------------------------------- */
+
+void Particle::reorder_custom(int *permute)
+{
+  int m,n,ncol;
+
+  for (m = 0; m < ncustom_ivec; m++) {
+    int *ivector;
+    memory->create(ivector,maxlocal,"particle:eivec");
+    for (n = 0; n < nlocal; n++) ivector[n] = eivec[m][permute[n]];
+    memset(&ivector[nlocal],0,(maxlocal-nlocal)*sizeof(int));
+    memory->destroy(eivec[m]);
+    eivec[m] = ivector;
+  }
+
+  for (m = 0; m < ncustom_iarray; m++) {
+    int **iarray;
+    ncol = eicol[m];
+    memory->create(iarray,maxlocal,ncol,"particle:eiarray");
+    for (n = 0; n < nlocal; n++)
+      memcpy(iarray[n],eiarray[m][permute[n]],ncol*sizeof(int));
+    memset(&iarray[0][nlocal*ncol],0,(maxlocal-nlocal)*ncol*sizeof(int));
+    memory->destroy(eiarray[m]);
+    eiarray[m] = iarray;
+  }
+
+  for (m = 0; m < ncustom_dvec; m++) {
+    double *dvector;
+    memory->create(dvector,maxlocal,"particle:edvec");
+    for (n = 0; n < nlocal; n++) dvector[n] = edvec[m][permute[n]];
+    memset(&dvector[nlocal],0,(maxlocal-nlocal)*sizeof(double));
+    memory->destroy(edvec[m]);
+    edvec[m] = dvector;
+  }
+
+  for (m = 0; m < ncustom_darray; m++) {
+    double **darray;
+    ncol = edcol[m];
+    memory->create(darray,maxlocal,ncol,"particle:edarray");
+    for (n = 0; n < nlocal; n++)
+      memcpy(darray[n],edarray[m][permute[n]],ncol*sizeof(double));
+    memset(&darray[0][nlocal*ncol],0,(maxlocal-nlocal)*ncol*sizeof(double));
+    memory->destroy(edarray[m]);
+    edarray[m] = darray;
+  }
+}
+
 /* ----------------------------------------------------------------------
    reallocate next list if necessary
    called before partial sort by FixEmit classes in subsonic case
@@ -475,6 +803,8 @@ void Particle::sort()
 
 void Particle::sort_allocate()
 {
+  incremental = 0;
+
   if (maxsort < maxlocal) {
     maxsort = maxlocal;
     memory->destroy(next);
@@ -491,6 +821,8 @@ void Particle::sort_allocate()
 
 void Particle::remove_all_from_cell(int ip)
 {
+  incremental = 0;
+
   while (ip >= 0) {
     particles[ip].icell = -1;
     ip = next[ip];
@@ -530,6 +862,8 @@ void Particle::post_weight()
   int nbytes = sizeof(OnePart);
   Grid::ChildInfo *cinfo = grid->cinfo;
 
+  incremental = 0;
+
   // nlocal_original-1 = index of last original particle
 
   int nlocal_original = nlocal;
@@ -2036,6 +2370,7 @@ bigint Particle::memory_usage()
 {
   bigint bytes = (bigint) maxlocal * sizeof(OnePart);
   bytes += (bigint) maxlocal * sizeof(int);
+  bytes += (bigint) 2*maxlink * sizeof(int);
   for (int i = 0; i < ncustom_ivec; i++)
     bytes += (bigint) maxlocal * sizeof(int);
   for (int i = 0; i < ncustom_iarray; i++)
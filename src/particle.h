@@ -24,6 +24,8 @@ class Particle : protected Pointers {
  public:
   int exist;                // 1 if particles exist
   int sorted;               // 1 if particles are sorted by grid cell
+  int contiguous;           // 1 if sorted particles were also reordered
+                            //   so each cell's particles are contiguous
 
   struct Species {          // info on each particle species, read from file
     char id[16];            // species ID
@@ -64,15 +66,25 @@ class Particle : protected Pointers {
   int nmixture;
   int maxmixture;
 
+  // fields are ordered hot to cold with no padding (96 bytes)
+  // 1st 64 bytes = id,ispecies,icell,flag,x,v, read by every particle sweep
+  // Update::move() also reads dtremain, and weight is read when
+  //   particle weighting is enabled, both of which lie past byte 64
+  // not split into separate hot and cold arrays, b/c whole OnePart structs
+  //   are memcpy'd when particles are copied, reordered, and packed with
+  //   migrating grid cells, by many styles and by the KOKKOS package
+  // restart files use OnePartRestart, so they do not depend on this layout
+  // do not insert fields ahead of erot without re-checking this
+
   struct OnePart {
     int id;                 // particle ID
     int ispecies;           // particle species index
     int icell;              // which local Grid::cells the particle is in
+    int flag;               // used for migration status
     double x[3];            // particle position
     double v[3];            // particle velocity
     double erot;            // rotational energy
     double evib;            // vibrational energy
-    int flag;               // used for migration status
     double dtremain;        // portion of move timestep remaining
     double weight;          // particle or cell weight, if weighting enabled
   };
@@ -102,6 +114,15 @@ class Particle : protected Pointers {
 
   int *next;                // index of next particle in each grid cell
 
+  // state for sort_incremental(), only valid when incremental = 1
+  // dirty = indices of particles whose icell may have changed since last sort
+  // filled by Update::move() and by compressions of the particle list
+
+  int incremental;          // 1 if cell lists can be patched incrementally
+  int ndirty;               // # of indices in dirty list
+  int maxdirty;             // max # of indices dirty list can hold
+  int *dirty;               // list of particle indices to re-check
+
   // extra custom vectors/arrays for per-particle data
   // ncustom > 0 if there are any extra arrays
   // custom attributes are created by various commands
@@ -137,7 +158,10 @@ class Particle : protected Pointers {
   void compress_rebalance_sorted();
   void compress_reactions(int, int *);
   void sort();
+  void sort_incremental();
+  void reorder();
   void sort_allocate();
+  void grow_dirty(int);
   void remove_all_from_cell(int);
   virtual void grow(int);
   virtual void grow_species();
@@ -184,6 +208,13 @@ class Particle : protected Pointers {
   int me;
   int maxgrid;              // max # of indices first can hold
   int maxsort;              // max # of particles next can hold
+  int maxlink;              // max # of particles prev,scell can hold
+  int nlinked;              // # of list indices linked into cell lists
+  int nlow;                 // min nlocal since last sort_incremental()
+  int *prev;                // index of previous particle in each grid cell
+  int *scell;               // cell each list index is linked into, -1 if none
+  int maxscratch;           // max # of indices scratch can hold
+  int *scratch;             // scratch vector for compress_reactions()
   int maxspecies;           // max size of species list
 
   FILE *fp;                 // file pointer for species, rotation, vibration
@@ -224,6 +255,9 @@ class Particle : protected Pointers {
   void read_rotation_file();
   void read_vibration_file();
   int wordcount(char *, char **);
+  void reorder_custom(int *);
+  void unlink(int);
+  void relink(int);
 };
 
 }
@@ -14,14 +14,11 @@
 
 #include "math.h"
 #include "random_park.h"
+#include "random_philox.h"
 
 using namespace SPARTA_NS;
 
-#define IA 16807
 #define IM 2147483647
-#define AM (1.0/IM)
-#define IQ 127773
-#define IR 2836
 
 /* ---------------------------------------------------------------------- 
    Park/Miller RNG
@@ -32,6 +29,7 @@ RanPark::RanPark(int iseed)
 {
   seed = iseed;
   save = 0;
+  philox = NULL;
 }
 
 /* ---------------------------------------------------------------------- 
@@ -44,6 +42,14 @@ RanPark::RanPark(double rseed)
   seed = static_cast<int> (rseed*IM);
   if (seed == 0) seed = 1;
   save = 0;
+  philox = NULL;
+}
+
+/* ---------------------------------------------------------------------- */
+
+RanPark::~RanPark()
+{
+  delete philox;
 }
 
 /* ---------------------------------------------------------------------- 
@@ -63,16 +69,52 @@ void RanPark::reset(double rseed, int offset, int warmup)
 }
 
 /* ----------------------------------------------------------------------
-   uniform RN 
+   switch to counter-based draws from a RanPhilox keyed by rseed
+   assume 0.0 <= rseed < 1.0, rseed < 0.0 switches back to Park/Miller
+   caller must invoke stream() before drawing, so that the RNs
+     depend on what is being computed and not on which proc computes it
 ------------------------------------------------------------------------- */
 
-double RanPark::uniform()
+void RanPark::counter(double rseed)
 {
-  int k = seed/IQ;
-  seed = IA*(seed-k*IQ) - IR*k;
-  if (seed < 0) seed += IM;
-  double ans = AM*seed;
-  return ans;
+  delete philox;
+  philox = NULL;
+  if (rseed >= 0.0) philox = new RanPhilox(rseed);
+  save = 0;
+}
+
+/* ----------------------------------------------------------------------
+   select counter-based stream, e.g. by timestep, cell ID, sub cell
+   no-op if counter() has not been used
+------------------------------------------------------------------------- */
+
+void RanPark::stream(uint64_t a, uint64_t b, uint64_t c)
+{
+  if (!philox) return;
+  philox->reset(a,b,c);
+  save = 0;
+}
+
+/* ----------------------------------------------------------------------
+   uniform RN from counter-based generator
+------------------------------------------------------------------------- */
+
+double RanPark::uniform_philox()
+{
+  return philox->uniform();
+}
+
+/* ----------------------------------------------------------------------
+   N uniform RNs, same values as N successive calls to uniform()
+------------------------------------------------------------------------- */
+
+void RanPark::uniform(int n, double *r)
+{
+  if (philox) {
+    philox->uniform(n,r);
+    return;
+  }
+  for (int i = 0; i < n; i++) r[i] = uniform();
 }
 
 /* ----------------------------------------------------------------------
@@ -15,20 +15,44 @@
 #ifndef SPARTA_RAN_PARK_H
 #define SPARTA_RAN_PARK_H
 
+#include "stdint.h"
+
 namespace SPARTA_NS {
 
 class RanPark {
  public:
   RanPark(int);
   RanPark(double);
-  ~RanPark() {}
+  ~RanPark();
   void reset(double, int, int);
-  double uniform();
+  void counter(double);
+  void stream(uint64_t, uint64_t, uint64_t);
+  double uniform() {
+    if (philox) return uniform_philox();
+    int k = seed/127773;
+    seed = 16807*(seed-k*127773) - 2836*k;
+    if (seed < 0) seed += 2147483647;
+    double ans = (1.0/2147483647)*seed;
+    return ans;
+  }
+  void uniform(int, double *);
   double gaussian();
 
  private:
   int seed,save;
   double second;
+  class RanPhilox *philox;   // counter-based generator, NULL if not used
+
+  // uniform() does Park/Miller draws inline, with IA = 16807,
+  //   IM = 2147483647, IQ = 127773, IR = 2836, and AM = 1/IM
+  // philox draws are out of line, since RanPhilox is only declared here
+
+  double uniform_philox();
+
+  // not implemented, since class owns philox
+
+  RanPark(const RanPark &);
+  RanPark &operator=(const RanPark &);
 };
 
 }
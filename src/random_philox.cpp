@@ -0,0 +1,139 @@
+/* ----------------------------------------------------------------------
+   SPARTA - Stochastic PArallel Rarefied-gas Time-accurate Analyzer
+   http://sparta.sandia.gov
+   Steve Plimpton, sjplimp@sandia.gov, Michael Gallis, magalli@sandia.gov
+   Sandia National Laboratories
+
+   Copyright (2014) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level SPARTA directory.
+------------------------------------------------------------------------- */
+
+// Philox4x32-10 counter-based random number generator
+// see Salmon, Moraes, Dror, Shaw, Proc SC11, 16 (2011)
+
+#include "random_philox.h"
+
+using namespace SPARTA_NS;
+
+#define M0 0xD2511F53U
+#define M1 0xCD9E8D57U
+#define W0 0x9E3779B9U
+#define W1 0xBB67AE85U
+#define IM 2147483647
+#define TWOM32 (1.0/4294967296.0)
+
+/* ----------------------------------------------------------------------
+   10 rounds of Philox on counter c with key k, result in r
+   a pure function of c,k so loops over many counters can vectorize
+------------------------------------------------------------------------- */
+
+static inline void philox(uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3,
+                          uint32_t k0, uint32_t k1, uint32_t *r)
+{
+  for (int i = 0; i < 10; i++) {
+    uint64_t p0 = (uint64_t) M0 * c0;
+    uint64_t p1 = (uint64_t) M1 * c2;
+    uint32_t hi0 = (uint32_t) (p0 >> 32);
+    uint32_t hi1 = (uint32_t) (p1 >> 32);
+    c0 = hi1 ^ c1 ^ k0;
+    c1 = (uint32_t) p1;
+    c2 = hi0 ^ c3 ^ k1;
+    c3 = (uint32_t) p0;
+    k0 += W0;
+    k1 += W1;
+  }
+  r[0] = c0;
+  r[1] = c1;
+  r[2] = c2;
+  r[3] = c3;
+}
+
+/* ----------------------------------------------------------------------
+   assume 0.0 <= rseed < 1.0, same as RanPark
+   no draws are valid until reset() selects a stream
+------------------------------------------------------------------------- */
+
+RanPhilox::RanPhilox(double rseed)
+{
+  seed = static_cast<uint32_t> (rseed*IM);
+  reset(0,0,0);
+}
+
+/* ----------------------------------------------------------------------
+   select stream identified by 3 integers, e.g. timestep, cell ID, sub cell
+   low 32 bits of each go into the counter, high 32 bits are mixed into key
+   draws restart from the beginning of the stream
+------------------------------------------------------------------------- */
+
+void RanPhilox::reset(uint64_t a, uint64_t b, uint64_t c)
+{
+  uint32_t ahi = (uint32_t) (a >> 32);
+  uint32_t bhi = (uint32_t) (b >> 32);
+  uint32_t chi = (uint32_t) (c >> 32);
+
+  key[0] = seed;
+  key[1] = ahi ^ ((bhi << 11) | (bhi >> 21)) ^ ((chi << 22) | (chi >> 10));
+  ctr[0] = 0;
+  ctr[1] = (uint32_t) a;
+  ctr[2] = (uint32_t) b;
+  ctr[3] = (uint32_t) c;
+  nbuf = 4;
+}
+
+/* ----------------------------------------------------------------------
+   uniform RN in (0,1), never exactly 0.0 or 1.0
+------------------------------------------------------------------------- */
+
+double RanPhilox::uniform()
+{
+  if (nbuf == 4) {
+    block(ctr[0]++,buf);
+    nbuf = 0;
+  }
+  return buf[nbuf++];
+}
+
+/* ----------------------------------------------------------------------
+   N uniform RNs into r
+   same values as N successive calls to uniform()
+   whole blocks of 4 are generated by a loop with no carried dependence
+------------------------------------------------------------------------- */
+
+void RanPhilox::uniform(int n, double *r)
+{
+  int m = 0;
+  while (nbuf < 4 && m < n) r[m++] = buf[nbuf++];
+  if (m == n) return;
+
+  int nblock = (n-m) / 4;
+  uint32_t c0 = ctr[0];
+  double *rr = &r[m];
+
+  for (int i = 0; i < nblock; i++) {
+    uint32_t out[4];
+    philox(c0+i,ctr[1],ctr[2],ctr[3],key[0],key[1],out);
+    rr[4*i] = (out[0] + 0.5) * TWOM32;
+    rr[4*i+1] = (out[1] + 0.5) * TWOM32;
+    rr[4*i+2] = (out[2] + 0.5) * TWOM32;
+    rr[4*i+3] = (out[3] + 0.5) * TWOM32;
+  }
+
+  ctr[0] = c0 + nblock;
+  m += 4*nblock;
+  while (m < n) r[m++] = uniform();
+}
+
+/* ----------------------------------------------------------------------
+   4 uniform RNs for block I of current stream
+------------------------------------------------------------------------- */
+
+void RanPhilox::block(uint32_t i, double *r)
+{
+  uint32_t out[4];
+  philox(i,ctr[1],ctr[2],ctr[3],key[0],key[1],out);
+  for (int k = 0; k < 4; k++) r[k] = (out[k] + 0.5) * TWOM32;
+}
@@ -0,0 +1,42 @@
+/* ----------------------------------------------------------------------
+   SPARTA - Stochastic PArallel Rarefied-gas Time-accurate Analyzer
+   http://sparta.sandia.gov
+   Steve Plimpton, sjplimp@sandia.gov, Michael Gallis, magalli@sandia.gov
+   Sandia National Laboratories
+
+   Copyright (2014) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level SPARTA directory.
+------------------------------------------------------------------------- */
+
+#ifndef SPARTA_RAN_PHILOX_H
+#define SPARTA_RAN_PHILOX_H
+
+#include "stdint.h"
+
+namespace SPARTA_NS {
+
+class RanPhilox {
+ public:
+  RanPhilox(double);
+  ~RanPhilox() {}
+  void reset(uint64_t, uint64_t, uint64_t);
+  double uniform();
+  void uniform(int, double *);
+
+ private:
+  uint32_t seed;         // key word set by seed
+  uint32_t key[2];       // key of current stream
+  uint32_t ctr[4];       // counter, ctr[0] = block of 4 draws within stream
+  double buf[4];         // current block of draws
+  int nbuf;              // # of draws in buf already returned
+
+  void block(uint32_t, double *);
+};
+
+}
+
+#endif
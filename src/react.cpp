@@ -40,19 +40,37 @@ React::React(SPARTA *sparta, int, char **arg) : Pointers(sparta)
   double seed = update->ranmaster->uniform();
   random->reset(seed,comm->me,100);
 
-  copy = copymode = 0;
+  copy = copymode = threadflag = 0;
 }
 
 /* ---------------------------------------------------------------------- */
 
 React::~React()
 {
-  if (copy) return;
+  if (copy) {
+    if (threadflag) delete random;
+    return;
+  }
 
   delete [] style;
   delete random;
 }
 
+/* ----------------------------------------------------------------------
+   turn a shallow copy of a React class into a per-thread copy
+   called by copy_thread() of child classes on the new copy
+   copy gets its own RNG, seeded from RNG of class it was copied from
+------------------------------------------------------------------------- */
+
+void React::setup_thread(int ithread)
+{
+  copy = threadflag = 1;
+
+  double seed = random->uniform();
+  random = new RanPark(seed);
+  random->reset(seed,ithread,100);
+}
+
 /* ---------------------------------------------------------------------- */
 
 void React::modify_params(int narg, char **arg)
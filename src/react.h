@@ -34,9 +34,11 @@ class React : protected Pointers {
   Particle::OnePart *recomb_part3;  // ptr to 3rd particle in recomb reaction
 
   int copy,copymode;         // 1 if class copy
+  int threadflag;            // 1 if per-thread copy made by copy_thread()
 
   React(class SPARTA *, int, char **);
-  React(class SPARTA *sparta) : Pointers(sparta) { style = NULL; random = NULL; }
+  React(class SPARTA *sparta) : Pointers(sparta) 
+    { style = NULL; random = NULL; threadflag = 0; }
   virtual ~React();
   virtual void init() {}
   virtual int recomb_exist(int, int) = 0;
@@ -45,12 +47,16 @@ class React : protected Pointers {
                       double, double, double, double &, int &) = 0;
   virtual char *reactionID(int) = 0;
   virtual double extract_tally(int) = 0;
+  virtual React *copy_thread(int) {return NULL;}
+  virtual void merge_thread(React *) {}
 
   void modify_params(int, char **);
   RanPark* get_random() { return random; }
 
  protected:
   class RanPark *random;
+
+  virtual void setup_thread(int);
 };
 
 }
@@ -77,7 +77,10 @@ ReactBird::ReactBird(SPARTA *sparta) : React(sparta)
 
 ReactBird::~ReactBird()
 {
-  if (copy) return;
+  if (copy) {
+    if (threadflag) delete [] tally_reactions;
+    return;
+  }
 
   delete [] tally_reactions;
   delete [] tally_reactions_all;
@@ -878,6 +881,32 @@ char *ReactBird::reactionID(int m)
   return rlist[m].id;
 };
 
+/* ----------------------------------------------------------------------
+   turn a shallow copy of this class into a per-thread copy
+   copy gets its own reaction tallies, summed by merge_thread()
+------------------------------------------------------------------------- */
+
+void ReactBird::setup_thread(int ithread)
+{
+  React::setup_thread(ithread);
+
+  tally_reactions = new int[nlist];
+  for (int i = 0; i < nlist; i++) tally_reactions[i] = 0;
+}
+
+/* ----------------------------------------------------------------------
+   add reaction tallies of per-thread copy R to this class and zero them
+------------------------------------------------------------------------- */
+
+void ReactBird::merge_thread(React *r)
+{
+  int *tally = ((ReactBird *) r)->tally_reactions;
+  for (int i = 0; i < nlist; i++) {
+    tally_reactions[i] += tally[i];
+    tally[i] = 0;
+  }
+}
+
 /* ----------------------------------------------------------------------
    return tally associated with a reaction
 ------------------------------------------------------------------------- */
@@ -33,6 +33,7 @@ class ReactBird : public React {
                       double, double, double, double &, int &) = 0;
   char *reactionID(int);
   virtual double extract_tally(int);
+  void merge_thread(React *);
 
  protected:
   FILE *fp;
@@ -42,6 +43,8 @@ class ReactBird : public React {
   int *tally_reactions,*tally_reactions_all;
   int tally_flag;
 
+  void setup_thread(int);
+
   struct OneReaction {
     int active;                    // 1 if reaction is active
     int initflag;                  // 1 if reaction params have been init
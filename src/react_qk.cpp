@@ -50,6 +50,17 @@ void ReactQK::init()
                  "React qk does not currently support recombination reactions");
 }
 
+/* ----------------------------------------------------------------------
+   create a per-thread copy of this class for Collide
+------------------------------------------------------------------------- */
+
+React *ReactQK::copy_thread(int ithread)
+{
+  ReactQK *r = new ReactQK(*this);
+  r->setup_thread(ithread);
+  return r;
+}
+
 /* ---------------------------------------------------------------------- */
 
 int ReactQK::attempt(Particle::OnePart *ip, Particle::OnePart *jp, 
@@ -46,6 +46,17 @@ void ReactTCE::init()
   ReactBird::init();
 }
 
+/* ----------------------------------------------------------------------
+   create a per-thread copy of this class for Collide
+------------------------------------------------------------------------- */
+
+React *ReactTCE::copy_thread(int ithread)
+{
+  ReactTCE *r = new ReactTCE(*this);
+  r->setup_thread(ithread);
+  return r;
+}
+
 /* ---------------------------------------------------------------------- */
 
 int ReactTCE::attempt(Particle::OnePart *ip, Particle::OnePart *jp, 
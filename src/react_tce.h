@@ -32,6 +32,7 @@ class ReactTCE : public ReactBird {
   void init();
   int attempt(Particle::OnePart *, Particle::OnePart *, 
               double, double, double, double &, int &);
+  React *copy_thread(int);
 };
 
 }
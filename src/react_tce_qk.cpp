@@ -49,6 +49,17 @@ void ReactTCEQK::init()
                  "React qk does not currently support recombination reactions");
 }
 
+/* ----------------------------------------------------------------------
+   create a per-thread copy of this class for Collide
+------------------------------------------------------------------------- */
+
+React *ReactTCEQK::copy_thread(int ithread)
+{
+  ReactTCEQK *r = new ReactTCEQK(*this);
+  r->setup_thread(ithread);
+  return r;
+}
+
 /* ---------------------------------------------------------------------- */
 
 int ReactTCEQK::attempt(Particle::OnePart *ip, Particle::OnePart *jp, 
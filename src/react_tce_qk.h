@@ -32,6 +32,7 @@ class ReactTCEQK : public ReactBird {
   void init();
   int attempt(Particle::OnePart *, Particle::OnePart *, 
               double, double, double, double &, int &);
+  React *copy_thread(int);
 
  private:
   int attempt_tce(Particle::OnePart *, Particle::OnePart *, OneReaction *, 
@@ -30,6 +30,7 @@ enum{UNKNOWN,OUTSIDE,INSIDE,OVERLAP};   // same as Grid
 
 #define MAXLINE 1024        // max line length in dump file
 #define CHUNK 1024
+#define UNIFORMWALK -2      // same as Grid
 
 /* ---------------------------------------------------------------------- */
 
@@ -202,8 +203,13 @@ void ReadParticles::process_particles(int n, int, double **fields)
     // id_find_child() recurses from root cell to find owning child cell
     // assumes x is inside or on surface of parent cell
     // returned icell can be owned or ghost cell
+    // for a uniform grid, id_find_uniform() finds owned cell directly,
+    //   only recurse if x is too close to a cell face for it to decide
 
-    icell = grid->id_find_child(0,x);
+    if (grid->ucellflag) {
+      icell = grid->id_find_uniform(x);
+      if (icell == UNIFORMWALK) icell = grid->id_find_child(0,x);
+    } else icell = grid->id_find_child(0,x);
     if (icell < 0 || cells[icell].proc != me) continue;
         
     id = static_cast<int> (fields[i][0]);
@@ -308,9 +308,11 @@ void ReadSurf::command(int narg, char **arg)
               100.0*(time6-time5)/time_total,100.0*(time7-time6)/time_total,
               100.0*(time8-time7)/time_total);
       fprintf(screen,"  surf2grid time = %g secs\n",time_s2g);
-      fprintf(screen,"  map/rvous1/rvous2/split percent = %g %g %g %g\n",
+      fprintf(screen,"  map/rvous1/rvous2/cut/split percent = "
+              "%g %g %g %g %g\n",
               100.0*grid->tmap/time_s2g,100.0*grid->trvous1/time_s2g,
-              100.0*grid->trvous2/time_s2g,100.0*grid->tsplit/time_s2g);
+              100.0*grid->trvous2/time_s2g,100.0*grid->tcutcell/time_s2g,
+              100.0*grid->tsplit/time_s2g);
     }
 
     if (logfile) {
@@ -325,9 +327,11 @@ void ReadSurf::command(int narg, char **arg)
               100.0*(time6-time5)/time_total,100.0*(time7-time6)/time_total,
               100.0*(time8-time7)/time_total);
       fprintf(logfile,"  surf2grid time = %g secs\n",time_s2g);
-      fprintf(logfile,"  map/rvous1/rvous2/split percent = %g %g %g %g\n",
+      fprintf(logfile,"  map/rvous1/rvous2/cut/split percent = "
+              "%g %g %g %g %g\n",
               100.0*grid->tmap/time_s2g,100.0*grid->trvous1/time_s2g,
-              100.0*grid->trvous2/time_s2g,100.0*grid->tsplit/time_s2g);
+              100.0*grid->trvous2/time_s2g,100.0*grid->tcutcell/time_s2g,
+              100.0*grid->tsplit/time_s2g);
     }
   }
 }
@@ -0,0 +1,412 @@
+/* ----------------------------------------------------------------------
+   SPARTA - Stochastic PArallel Rarefied-gas Time-accurate Analyzer
+   http://sparta.sandia.gov
+   Steve Plimpton, sjplimp@sandia.gov, Michael Gallis, magalli@sandia.gov
+   Sandia National Laboratories
+
+   Copyright (2014) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level SPARTA directory.
+------------------------------------------------------------------------- */
+
+// Notes:
+//   dots are ordered along a Hilbert curve thru the simulation box
+//   curve is cut into nprocs contiguous pieces of equal weight (if used)
+//   cuts are found by refining a global histogram of dot weights
+//     binned by key, no dots move until the caller migrates them
+//   diffuse() moves previous cuts a bounded amount instead
+//   if defined, input weights must be real numbers > 0.0
+
+#include "mpi.h"
+#include "string.h"
+#include "sfc.h"
+#include "domain.h"
+#include "memory.h"
+#include "error.h"
+
+using namespace SPARTA_NS;
+
+#define MIN(A,B) ((A) < (B) ? (A) : (B))
+#define MAX(A,B) ((A) > (B) ? (A) : (B))
+#define NBIN 64                       // # of histogram bins per interval
+#define MAXKEY (((uint64_t) 1) << 63) // all keys are less than this
+
+/* ---------------------------------------------------------------------- */
+
+SFC::SFC(SPARTA *sparta) : Pointers(sparta)
+{
+  MPI_Comm_rank(world,&me);
+  MPI_Comm_size(world,&nprocs);
+
+  nkeep = 0;
+  niterate = 0;
+  maxdot = 0;
+  key = NULL;
+  sendproc = NULL;
+
+  memory->create(cut,nprocs,"sfc:cut");
+  memory->create(cutlo,nprocs,"sfc:cutlo");
+  memory->create(cuthi,nprocs,"sfc:cuthi");
+  memory->create(wtlo,nprocs,"sfc:wtlo");
+  memory->create(active,nprocs,"sfc:active");
+  memory->create(target,nprocs,"sfc:target");
+  memory->create(wtproc,nprocs,"sfc:wtproc");
+  memory->create(wtprev,nprocs,"sfc:wtprev");
+  cutflag = 0;
+
+  maxhist = 0;
+  hist = histall = NULL;
+}
+
+/* ---------------------------------------------------------------------- */
+
+SFC::~SFC()
+{
+  memory->destroy(key);
+  memory->destroy(sendproc);
+  memory->destroy(cut);
+  memory->destroy(cutlo);
+  memory->destroy(cuthi);
+  memory->destroy(wtlo);
+  memory->destroy(active);
+  memory->destroy(target);
+  memory->destroy(wtproc);
+  memory->destroy(wtprev);
+  memory->destroy(hist);
+  memory->destroy(histall);
+}
+
+/* ----------------------------------------------------------------------
+   partition N dots with coords X and optional weights WT
+   cut K = smallest key owned by proc K, K = 1 to P-1
+     where weight of all dots along curve reaches K/P of total weight
+   sets sendproc = proc each dot is assigned to, nkeep = # assigned to me
+------------------------------------------------------------------------- */
+
+void SFC::compute(int n, double **x, double *wt)
+{
+  setup(n,x,wt);
+  for (int k = 1; k < nprocs; k++) target[k] = k*wttotal/nprocs;
+  partition(n,wt);
+  assign(n);
+}
+
+/* ----------------------------------------------------------------------
+   incrementally re-partition N dots with coords X and optional weights WT
+   each cut from previous compute() or diffuse() moves along the curve
+     towards where compute() would put it, but only by up to
+     FRACTION of the average weight per proc,
+     and never past the previous cuts before and after it
+   so each proc gains or loses at most 2*FRACTION of the average weight,
+     and only to or from the procs before and after it along the curve
+   limits how many dots migrate, not communication to find cuts,
+     which uses an O(P) Allreduce here and in partition()
+   dots not owned by the proc the previous cuts assign them to,
+     e.g. new cells from grid adaptation, migrate to their owner on curve
+   if no previous cuts exist, perform a full partitioning
+------------------------------------------------------------------------- */
+
+void SFC::diffuse(int n, double **x, double *wt, double fraction)
+{
+  if (!cutflag) {
+    compute(n,x,wt);
+    return;
+  }
+
+  setup(n,x,wt);
+
+  // wtprev[K] = weight of all dots between previous cuts K and K+1
+  // Allreduce of P values, so O(P) msg size
+
+  for (int k = 0; k < nprocs; k++) wtproc[k] = 0.0;
+  for (int i = 0; i < n; i++) {
+    if (wt) wtproc[owner(key[i])] += wt[i];
+    else wtproc[owner(key[i])] += 1.0;
+  }
+
+  MPI_Allreduce(wtproc,wtprev,nprocs,MPI_DOUBLE,MPI_SUM,world);
+
+  // target of cut K = desired weight below it, clamped to within
+  //   maxshift of weight below its previous position
+  // also clamped to between weight below previous cuts K-1 and K+1,
+  //   so proc K only trades dots with procs K-1 and K+1
+  // remains monotonic in K since both bounds and desired weight are
+
+  double maxshift = fraction*wttotal/nprocs;
+  double below = 0.0;
+  double desired,lo,hi;
+
+  for (int k = 1; k < nprocs; k++) {
+    below += wtprev[k-1];
+    desired = k*wttotal/nprocs;
+    lo = MAX(below-maxshift,below-wtprev[k-1]);
+    hi = MIN(below+maxshift,below+wtprev[k]);
+    if (desired < lo) desired = lo;
+    if (desired > hi) desired = hi;
+    target[k] = desired;
+  }
+
+  partition(n,wt);
+  assign(n);
+}
+
+/* ----------------------------------------------------------------------
+   compute Hilbert key of each dot and total weight of all dots
+------------------------------------------------------------------------- */
+
+void SFC::setup(int n, double **x, double *wt)
+{
+  if (n > maxdot) {
+    memory->destroy(key);
+    memory->destroy(sendproc);
+    maxdot = n;
+    memory->create(key,maxdot,"sfc:key");
+    memory->create(sendproc,maxdot,"sfc:sendproc");
+  }
+
+  for (int i = 0; i < n; i++) key[i] = hilbert(x[i]);
+
+  // wttotal = total weight of all dots, each is 1.0 if no weights
+
+  double mywt = 0.0;
+  if (wt) for (int i = 0; i < n; i++) mywt += wt[i];
+  else mywt = n;
+
+  MPI_Allreduce(&mywt,&wttotal,1,MPI_DOUBLE,MPI_SUM,world);
+}
+
+/* ----------------------------------------------------------------------
+   find cut K = key where weight of all dots along curve reaches target[K]
+   each iteration splits the key interval of every cut not yet found
+     into NBIN bins, sums weight and count of dots in each bin across procs,
+     and narrows the interval to the bin where the cut's target weight is
+   cut is found when its bin holds a single dot,
+     dot is assigned to whichever side its weight fits better
+   cuts with the same interval share bins, different intervals are disjoint
+   only intervals of cuts not yet found are refined
+   work per iteration is O(N/P) + one MPI_Allreduce of 2*NBIN doubles
+     per distinct interval, which is up to P-1 intervals, so O(P) msg size
+   # of iterations is log base NBIN of # of dots
+------------------------------------------------------------------------- */
+
+void SFC::partition(int n, double *wt)
+{
+  int i,k,m,ibin,first,last,mid;
+  uint64_t binlo,binhi,width;
+  double sum,w;
+
+  // initial interval of each cut is entire curve
+
+  cut[0] = 0;
+  for (k = 1; k < nprocs; k++) {
+    cut[k] = 0;
+    cutlo[k] = 0;
+    cuthi[k] = MAXKEY;
+    wtlo[k] = 0.0;
+    active[k] = 1;
+    if (wttotal == 0.0) active[k] = 0;
+  }
+
+  int *interval = new int[nprocs];
+  uint64_t *ilo = new uint64_t[nprocs];
+  uint64_t *ihi = new uint64_t[nprocs];
+  uint64_t *ibw = new uint64_t[nprocs];
+
+  niterate = 0;
+
+  while (1) {
+
+    // interval[k] = which distinct interval active cut K is in
+    // ilo,ihi = bounds of each interval, ibw = width of its bins
+
+    int nintv = 0;
+    for (k = 1; k < nprocs; k++) {
+      if (!active[k]) continue;
+      if (nintv == 0 || cutlo[k] != ilo[nintv-1]) {
+        ilo[nintv] = cutlo[k];
+        ihi[nintv] = cuthi[k];
+        width = cuthi[k] - cutlo[k];
+        ibw[nintv] = width/NBIN + (width % NBIN ? 1 : 0);
+        nintv++;
+      }
+      interval[k] = nintv-1;
+    }
+
+    if (nintv == 0) break;
+    niterate++;
+
+    // histogram of weight and count of my dots in bins of each interval
+    // binary search for interval with largest ilo <= key
+
+    if (2*NBIN*nintv > maxhist) {
+      memory->destroy(hist);
+      memory->destroy(histall);
+      maxhist = 2*NBIN*nintv;
+      memory->create(hist,maxhist,"sfc:hist");
+      memory->create(histall,maxhist,"sfc:histall");
+    }
+
+    memset(hist,0,2*NBIN*nintv*sizeof(double));
+
+    for (i = 0; i < n; i++) {
+      if (key[i] < ilo[0]) continue;
+      first = 0;
+      last = nintv-1;
+      while (first < last) {
+        mid = (first+last+1) / 2;
+        if (ilo[mid] <= key[i]) first = mid;
+        else last = mid-1;
+      }
+      if (key[i] >= ihi[first]) continue;
+      ibin = (key[i] - ilo[first]) / ibw[first];
+      m = 2*(first*NBIN + ibin);
+      if (wt) hist[m] += wt[i];
+      else hist[m] += 1.0;
+      hist[m+1] += 1.0;
+    }
+
+    MPI_Allreduce(hist,histall,2*NBIN*nintv,MPI_DOUBLE,MPI_SUM,world);
+
+    // narrow interval of each active cut to bin where target weight is
+    // every proc does this identically, since all have same histogram
+
+    for (k = 1; k < nprocs; k++) {
+      if (!active[k]) continue;
+      m = interval[k];
+      sum = wtlo[k];
+
+      for (ibin = 0; ibin < NBIN; ibin++) {
+        binlo = ilo[m] + ibin*ibw[m];
+        if (binlo >= ihi[m]) break;
+        w = histall[2*(m*NBIN+ibin)];
+        if (sum + w >= target[k]) break;
+        sum += w;
+      }
+
+      // no bin reaches target due to round-off, cut at end of interval
+
+      if (ibin == NBIN || binlo >= ihi[m]) {
+        cut[k] = ihi[m];
+        active[k] = 0;
+        continue;
+      }
+
+      binhi = binlo + ibw[m];
+      if (binhi > ihi[m]) binhi = ihi[m];
+
+      if (histall[2*(m*NBIN+ibin)+1] <= 1.0 || ibw[m] == 1) {
+        if (target[k] - sum <= sum + w - target[k]) cut[k] = binlo;
+        else cut[k] = binhi;
+        active[k] = 0;
+      } else {
+        cutlo[k] = binlo;
+        cuthi[k] = binhi;
+        wtlo[k] = sum;
+      }
+    }
+  }
+
+  delete [] interval;
+  delete [] ilo;
+  delete [] ihi;
+  delete [] ibw;
+
+  cutflag = 1;
+}
+
+/* ----------------------------------------------------------------------
+   set sendproc of each dot to its owner for current cuts
+------------------------------------------------------------------------- */
+
+void SFC::assign(int n)
+{
+  nkeep = 0;
+  for (int i = 0; i < n; i++) {
+    sendproc[i] = owner(key[i]);
+    if (sendproc[i] == me) nkeep++;
+  }
+}
+
+/* ----------------------------------------------------------------------
+   proc which owns KEY for current cuts = # of cuts <= KEY
+------------------------------------------------------------------------- */
+
+int SFC::owner(uint64_t k)
+{
+  int first = 0;
+  int last = nprocs-1;
+  int mid;
+
+  while (first < last) {
+    mid = (first+last+1) / 2;
+    if (cut[mid] <= k) first = mid;
+    else last = mid-1;
+  }
+  return first;
+}
+
+/* ----------------------------------------------------------------------
+   Hilbert key of point X within simulation box
+   each coord is mapped to an integer with 21 bits in 3d, 31 bits in 2d
+   uses Skilling's transpose algorithm, AIP Conf Proc 707, 381 (2004),
+     then interleaves the transposed bits into a single key
+------------------------------------------------------------------------- */
+
+uint64_t SFC::hilbert(double *x)
+{
+  int i,ibit;
+  uint32_t c[3],p,q,t;
+
+  int dimension = domain->dimension;
+  int nbits = 31;
+  if (dimension == 3) nbits = 21;
+
+  double *boxlo = domain->boxlo;
+  double *prd = domain->prd;
+  double scale = (double) (((uint64_t) 1) << nbits);
+  double cmax = scale - 1.0;
+  double f;
+
+  for (i = 0; i < dimension; i++) {
+    f = (x[i]-boxlo[i])/prd[i] * scale;
+    if (f < 0.0) f = 0.0;
+    if (f > cmax) f = cmax;
+    c[i] = static_cast<uint32_t> (f);
+  }
+
+  // inverse undo excess work
+
+  uint32_t top = ((uint32_t) 1) << (nbits-1);
+
+  for (q = top; q > 1; q >>= 1) {
+    p = q - 1;
+    for (i = 0; i < dimension; i++) {
+      if (c[i] & q) c[0] ^= p;
+      else {
+        t = (c[0] ^ c[i]) & p;
+        c[0] ^= t;
+        c[i] ^= t;
+      }
+    }
+  }
+
+  // Gray encode
+
+  for (i = 1; i < dimension; i++) c[i] ^= c[i-1];
+  t = 0;
+  for (q = top; q > 1; q >>= 1)
+    if (c[dimension-1] & q) t ^= q - 1;
+  for (i = 0; i < dimension; i++) c[i] ^= t;
+
+  // interleave, most significant bits first
+
+  uint64_t h = 0;
+  for (ibit = nbits-1; ibit >= 0; ibit--)
+    for (i = 0; i < dimension; i++)
+      h = (h << 1) | ((c[i] >> ibit) & 1);
+
+  return h;
+}
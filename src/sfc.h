@@ -0,0 +1,70 @@
+/* ----------------------------------------------------------------------
+   SPARTA - Stochastic PArallel Rarefied-gas Time-accurate Analyzer
+   http://sparta.sandia.gov
+   Steve Plimpton, sjplimp@sandia.gov, Michael Gallis, magalli@sandia.gov
+   Sandia National Laboratories
+
+   Copyright (2014) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level SPARTA directory.
+------------------------------------------------------------------------- */
+
+#ifndef SPARTA_SFC_H
+#define SPARTA_SFC_H
+
+#include "stdint.h"
+#include "pointers.h"
+
+namespace SPARTA_NS {
+
+class SFC : protected Pointers {
+ public:
+  // set by compute()
+
+  int nkeep;                  // how many of my dots I still own
+  int *sendproc;              // proc to send each of my dots to
+  uint64_t *cut;              // key of 1st dot of each proc 1 to P-1
+  int niterate;               // # of histogram refinements performed
+
+  SFC(class SPARTA *);
+  ~SFC();
+  void compute(int, double **, double *);
+  void diffuse(int, double **, double *, double);
+
+ private:
+  int me,nprocs;
+
+  int maxdot;                 // length of key and sendproc
+  uint64_t *key;              // Hilbert key of each of my dots
+  double wttotal;             // total weight of all dots
+
+  int cutflag;                // 1 if cut holds a previous partitioning
+  double *target;             // weight of all dots below each cut
+  double *wtproc,*wtprev;     // weight of dots between each pair of cuts
+
+  // interval of keys that still contains cut of each proc 1 to P-1
+
+  uint64_t *cutlo,*cuthi;     // cut is in [cutlo,cuthi)
+  double *wtlo;               // total weight of all dots with key < cutlo
+  int *active;                // 1 if cut is not yet found
+
+  int maxhist;                // length of hist and histall
+  double *hist,*histall;      // weight and count of dots in each bin
+
+  void setup(int, double **, double *);
+  void partition(int, double *);
+  void assign(int);
+  int owner(uint64_t);
+  uint64_t hilbert(double *);
+};
+
+}
+
+#endif
+
+/* ERROR/WARNING messages:
+
+*/
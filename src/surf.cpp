@@ -13,6 +13,7 @@
 ------------------------------------------------------------------------- */
 
 #include "ctype.h"
+#include "stdint.h"
 #include "surf.h"
 #include "style_surf_collide.h"
 #include "style_surf_react.h"
@@ -33,7 +34,7 @@
 using namespace SPARTA_NS;
 using namespace MathConst;
 
-enum{TALLYAUTO,TALLYREDUCE,TALLYRVOUS};         // same as Update
+enum{TALLYAUTO,TALLYREDUCE,TALLYRVOUS,TALLYSCATTER};  // same as Update
 enum{REGION_ALL,REGION_ONE,REGION_CENTER};      // same as Grid
 enum{TYPE,MOLECULE,ID};
 enum{LT,LE,GT,GE,EQ,NEQ,BETWEEN};
@@ -44,6 +45,8 @@ enum{LT,LE,GT,GE,EQ,NEQ,BETWEEN};
 #define EPSILON_GRID 1.0e-3
 #define BIG 1.0e20
 #define MAXGROUP 32
+#define SPARSEFRAC 0.5        // max ratio of sparse to dense tally volume
+#define MAXDENSE 16777216     // max length of dense tally buffer
 
 /* ---------------------------------------------------------------------- */
 
@@ -88,6 +91,12 @@ Surf::Surf(SPARTA *sparta) : Pointers(sparta)
 
   tally_comm = TALLYAUTO;
 
+  cacheflag = 0;
+  ncache = maxcache = 0;
+  lcache = NULL;
+  tcache = NULL;
+  cachemem = NULL;
+
   // allocate hash for surf IDs
 
   hash = new MySurfHash();
@@ -107,6 +116,7 @@ Surf::~Surf()
   memory->sfree(tris);
   memory->sfree(mylines);
   memory->sfree(mytris);
+  memory->sfree(cachemem);
 
   for (int i = 0; i < nsc; i++) delete sc[i];
   memory->sfree(sc);
@@ -313,6 +323,7 @@ void Surf::clear()
   nsurf = 0;
   nlocal = nghost = 0;
   nown = 0;
+  ncache = 0;
   hash->clear();
   hashfilled = 0;
 }
@@ -324,6 +335,7 @@ void Surf::clear()
 void Surf::remove_ghosts()
 {
   nghost = 0;
+  ncache = 0;
 }
 
 /* ----------------------------------------------------------------------
@@ -671,6 +683,47 @@ void Surf::setup_owned()
   if (comm->me < nsurf % nprocs) nown++;
 }
 
+/* ----------------------------------------------------------------------
+   precompute intersection data for all nlocal+nghost lines or tris
+   records are aligned to cache lines, so one test touches 1 or 2 lines
+   not done for axisymmetric, which uses a different intersection test
+   called from Grid::acquire_ghosts() and when global surfcache is set
+------------------------------------------------------------------------- */
+
+void Surf::setup_cache()
+{
+  ncache = 0;
+  if (!cacheflag || !exist || domain->axisymmetric) return;
+
+  int dim = domain->dimension;
+  int n = nlocal + nghost;
+  if (n == 0) return;
+
+  int nbytes;
+  if (dim == 2) nbytes = sizeof(Geometry::LineCache);
+  else nbytes = sizeof(Geometry::TriCache);
+
+  if (n > maxcache) {
+    maxcache = n;
+    memory->sfree(cachemem);
+    cachemem = memory->smalloc((bigint) maxcache*nbytes + 64,"surf:cache");
+    uintptr_t ptr = ((uintptr_t) cachemem + 63) & ~((uintptr_t) 63);
+    lcache = (Geometry::LineCache *) ptr;
+    tcache = (Geometry::TriCache *) ptr;
+  }
+
+  if (dim == 2) {
+    for (int i = 0; i < n; i++)
+      Geometry::line_cache(lines[i].p1,lines[i].p2,lines[i].norm,lcache[i]);
+  } else {
+    for (int i = 0; i < n; i++)
+      Geometry::tri_cache(tris[i].p1,tris[i].p2,tris[i].p3,tris[i].norm,
+                          tcache[i]);
+  }
+
+  ncache = n;
+}
+
 /* ----------------------------------------------------------------------
    set bounding box around all surfs based on their pts
    for 2d, set zlo,zhi to box bounds
@@ -2589,6 +2642,29 @@ void Surf::compress_implicit_rebalance()
   nlocal = n;
 }
 
+/* ----------------------------------------------------------------------
+   choose collate algorithm for tally_comm = auto
+   nrow = # of surfs this proc tallied, ncol = # of values per surf
+   reduce if more procs than surfs, since each proc owns at most one
+   rvous if max tallies on any proc is sparse compared to the
+     dense N*ncol vector, or if dense vector would be too large
+   else scatter, which sends dense vector only to owners of each segment
+------------------------------------------------------------------------- */
+
+int Surf::collate_choose(int nrow, int ncol)
+{
+  if (nprocs > nsurf) return TALLYREDUCE;
+
+  bigint ndense = (bigint) nsurf * ncol;
+  if (ndense > MAXDENSE) return TALLYRVOUS;
+
+  int nrowmax;
+  MPI_Allreduce(&nrow,&nrowmax,1,MPI_INT,MPI_MAX,world);
+
+  if ((bigint) nrowmax*(ncol+1) < SPARSEFRAC*ndense) return TALLYRVOUS;
+  return TALLYSCATTER;
+}
+
 /* ----------------------------------------------------------------------
    comm of tallies across all procs
    nrow = # of tally entries in input vector
@@ -2602,20 +2678,23 @@ void Surf::collate_vector(int nrow, surfint *tally2surf,
                           double *in, int instride, double *out)
 {
   // collate version depends on tally_comm setting
+  // auto = choose based on surf count and density of tallies
+
+  int style = tally_comm;
+  if (style == TALLYAUTO) style = collate_choose(nrow,1);
 
-  if (tally_comm == TALLYAUTO) {
-    if (nprocs > nsurf) 
-      collate_vector_reduce(nrow,tally2surf,in,instride,out);
-    else collate_vector_rendezvous(nrow,tally2surf,in,instride,out);
-  } else if (tally_comm == TALLYREDUCE) {
+  if (style == TALLYREDUCE)
     collate_vector_reduce(nrow,tally2surf,in,instride,out);
-  } else if (tally_comm == TALLYRVOUS) {
+  else if (style == TALLYRVOUS)
     collate_vector_rendezvous(nrow,tally2surf,in,instride,out);
-  }
+  else if (style == TALLYSCATTER)
+    collate_vector_scatter(nrow,tally2surf,in,instride,out);
 }
 
 /* ----------------------------------------------------------------------
    allreduce version of collate
+   only nrow tallied rows are summed in, but the vector/array that is
+     zeroed and Allreduced is dense, of length nsurf on every proc
 ------------------------------------------------------------------------- */
 
 void Surf::collate_vector_reduce(int nrow, surfint *tally2surf, 
@@ -2634,6 +2713,7 @@ void Surf::collate_vector_reduce(int nrow, surfint *tally2surf,
   memory->create(all,nglobal,"surf:all");
 
   // zero all values and add in values I accumulated
+  // sum, since same surf ID can appear in more than one tally row
   
   for (i = 0; i < nglobal; i++) one[i] = 0.0;
 
@@ -2645,7 +2725,7 @@ void Surf::collate_vector_reduce(int nrow, surfint *tally2surf,
   j = 0;
   for (i = 0; i < nrow; i++) {
     m = (int) tally2surf[i] - 1;
-    one[m] = in[j];
+    one[m] += in[j];
     j += instride;
   }
 
@@ -2754,6 +2834,58 @@ int Surf::rendezvous_vector(int n, char *inbuf, int &flag, int *&proclist,
   return 0;
 }
 
+/* ----------------------------------------------------------------------
+   reduce-scatter version of collate
+   dense vector is ordered by owning proc, so that each proc
+     receives only the summed values of the N/P surfs it owns
+------------------------------------------------------------------------- */
+
+void Surf::collate_vector_scatter(int nrow, surfint *tally2surf,
+                                  double *in, int instride, double *out)
+{
+  int i,j,m,iproc;
+
+  if (nsurf > MAXSMALLINT)
+    error->all(FLERR,"Too many surfs to tally scatter - "
+               "use global surftally rvous");
+
+  int nglobal = nsurf;
+
+  double *one;
+  int *recvcounts;
+  memory->create(one,nglobal,"surf:one");
+  memory->create(recvcounts,nprocs,"surf:recvcounts");
+
+  // recvcounts = # of surfs each proc owns
+  // surf ID owned by proc (id-1) % nprocs as its (id-1) / nprocs surf
+  // offset of each proc's segment = sum of recvcounts of lower procs
+
+  int nper = nglobal / nprocs;
+  int nextra = nglobal % nprocs;
+  for (iproc = 0; iproc < nprocs; iproc++)
+    recvcounts[iproc] = nper + (iproc < nextra ? 1 : 0);
+
+  // zero all values and add in values I accumulated
+  // sum, since same surf ID can appear in more than one tally row
+
+  for (i = 0; i < nglobal; i++) one[i] = 0.0;
+
+  j = 0;
+  for (i = 0; i < nrow; i++) {
+    m = (int) tally2surf[i] - 1;
+    iproc = m % nprocs;
+    one[iproc*nper + MIN(iproc,nextra) + m/nprocs] += in[j];
+    j += instride;
+  }
+
+  // sum across all procs, each proc receives its own segment
+
+  MPI_Reduce_scatter(one,out,recvcounts,MPI_DOUBLE,MPI_SUM,world);
+
+  memory->destroy(one);
+  memory->destroy(recvcounts);
+}
+
 /* ----------------------------------------------------------------------
    comm of tallies across all procs
    nrow,ncol = # of entries and columns in input array
@@ -2767,20 +2899,23 @@ void Surf::collate_array(int nrow, int ncol, surfint *tally2surf,
                          double **in, double **out)
 {
   // collate version depends on tally_comm setting
+  // auto = choose based on surf count and density of tallies
+
+  int style = tally_comm;
+  if (style == TALLYAUTO) style = collate_choose(nrow,ncol);
 
-  if (tally_comm == TALLYAUTO) {
-    if (nprocs > nsurf) 
-      collate_array_reduce(nrow,ncol,tally2surf,in,out);
-    else collate_array_rendezvous(nrow,ncol,tally2surf,in,out);
-  } else if (tally_comm == TALLYREDUCE) {
+  if (style == TALLYREDUCE)
     collate_array_reduce(nrow,ncol,tally2surf,in,out);
-  } else if (tally_comm == TALLYRVOUS) {
+  else if (style == TALLYRVOUS)
     collate_array_rendezvous(nrow,ncol,tally2surf,in,out);
-  }
+  else if (style == TALLYSCATTER)
+    collate_array_scatter(nrow,ncol,tally2surf,in,out);
 }
 
 /* ----------------------------------------------------------------------
    allreduce version of collate
+   only nrow tallied rows are summed in, but the vector/array that is
+     zeroed and Allreduced is dense, of length nsurf on every proc
 ------------------------------------------------------------------------- */
 
 void Surf::collate_array_reduce(int nrow, int ncol, surfint *tally2surf, 
@@ -2801,6 +2936,7 @@ void Surf::collate_array_reduce(int nrow, int ncol, surfint *tally2surf,
   memory->create(all,nglobal,ncol,"surf:all");
 
   // zero all values and add in values I accumulated
+  // sum, since same surf ID can appear in more than one tally row
   
   for (i = 0; i < nglobal; i++)
     for (j = 0; j < ncol; j++)
@@ -2813,7 +2949,7 @@ void Surf::collate_array_reduce(int nrow, int ncol, surfint *tally2surf,
   for (i = 0; i < nrow; i++) {
     m = (int) tally2surf[i] - 1;
     for (j = 0; j < ncol; j++) 
-      one[m][j] = in[i][j];
+      one[m][j] += in[i][j];
   }
 
   // global allreduce
@@ -2934,6 +3070,64 @@ int Surf::rendezvous_array(int n, char *inbuf,
   return 0;
 }
 
+/* ----------------------------------------------------------------------
+   reduce-scatter version of collate
+   dense array is ordered by owning proc, so that each proc
+     receives only the summed values of the N/P surfs it owns
+------------------------------------------------------------------------- */
+
+void Surf::collate_array_scatter(int nrow, int ncol, surfint *tally2surf,
+                                 double **in, double **out)
+{
+  int i,j,k,m,iproc;
+
+  bigint ntotal = (bigint) nsurf * ncol;
+
+  if (ntotal > MAXSMALLINT)
+    error->all(FLERR,"Too many surfs to tally scatter - "
+               "use global surftally rvous");
+
+  int nglobal = nsurf;
+
+  double *one;
+  int *recvcounts;
+  memory->create(one,ntotal,"surf:one");
+  memory->create(recvcounts,nprocs,"surf:recvcounts");
+
+  // recvcounts = # of values for surfs each proc owns
+  // surf ID owned by proc (id-1) % nprocs as its (id-1) / nprocs surf
+  // offset of each proc's segment = sum of recvcounts of lower procs
+
+  int nper = nglobal / nprocs;
+  int nextra = nglobal % nprocs;
+  for (iproc = 0; iproc < nprocs; iproc++)
+    recvcounts[iproc] = (nper + (iproc < nextra ? 1 : 0)) * ncol;
+
+  // zero all values and add in values I accumulated
+  // sum, since same surf ID can appear in more than one tally row
+
+  for (bigint n = 0; n < ntotal; n++) one[n] = 0.0;
+
+  for (i = 0; i < nrow; i++) {
+    m = (int) tally2surf[i] - 1;
+    iproc = m % nprocs;
+    k = (iproc*nper + MIN(iproc,nextra) + m/nprocs) * ncol;
+    for (j = 0; j < ncol; j++)
+      one[k++] += in[i][j];
+  }
+
+  // sum across all procs, each proc receives its own segment
+  // out can be NULL if this proc owns no surfs
+
+  double *outvec = NULL;
+  if (out) outvec = &out[0][0];
+
+  MPI_Reduce_scatter(one,outvec,recvcounts,MPI_DOUBLE,MPI_SUM,world);
+
+  memory->destroy(one);
+  memory->destroy(recvcounts);
+}
+
 /* ----------------------------------------------------------------------
    comm of tallies across all procs
    called from compute isurf/grid and fix ave/grid
@@ -2960,6 +3154,9 @@ void Surf::collate_vector_implicit(int nrow, surfint *tally2surf,
   int nglocal = grid->nlocal;
 
   MyCellHash hash;
+#ifndef SPARTA_MAP
+  hash.reserve(nglocal);
+#endif
 
   for (int icell = 0; icell < nglocal; icell++) {
     if (cells[icell].nsplit <= 0) continue;
@@ -3087,6 +3284,9 @@ void Surf::collate_array_implicit(int nrow, int ncol, surfint *tally2surf,
   int nglocal = grid->nlocal;
 
   MyCellHash hash;
+#ifndef SPARTA_MAP
+  hash.reserve(nglocal);
+#endif
 
   for (int icell = 0; icell < nglocal; icell++) {
     if (cells[icell].nsplit <= 0) continue;
@@ -3246,7 +3446,7 @@ int Surf::rendezvous_implicit(int n, char *inbuf,
       m += ncol;                         // skip entries with novalues
       continue;
     }
-    if (ohash.find(cellID) == phash.end()) {  
+    if (ohash.find(cellID) == ohash.end()) {
       ohash[cellID] = nout;              // add a new set of out values
       proclist[nout] = phash[cellID];
       out[k++] = cellID;
@@ -3740,5 +3940,9 @@ bigint Surf::memory_usage()
     bytes += nlocal * sizeof(int);
   }
 
+  if (domain->dimension == 2) 
+    bytes += (bigint) maxcache * sizeof(Geometry::LineCache);
+  else bytes += (bigint) maxcache * sizeof(Geometry::TriCache);
+
   return bytes;
 }
@@ -20,6 +20,7 @@
 #include "pointers.h"
 #include "hash3.h"
 #include "hashlittle.h"
+#include "geometry.h"
 
 namespace SPARTA_NS {
 
@@ -110,6 +111,14 @@ class Surf : protected Pointers {
   class SurfCollide **sc;   // list of surface collision models
   class SurfReact **sr;     // list of surface reaction models
 
+  // precomputed intersection data for nlocal+nghost lines or tris
+  // used by Update::move(), rebuilt by Grid::acquire_ghosts()
+
+  int cacheflag;            // 1 if intersection data is cached
+  int ncache;               // # of surfs in cache, 0 if stale
+  Geometry::LineCache *lcache;  // per-line data, 2d
+  Geometry::TriCache *tcache;   // per-tri data, 3d
+
   int pushflag;             // set to 1 to push surf pts near grid cell faces
   double pushlo,pushhi;     // lo/hi ranges to push on
   double pushvalue;         // new position to push to
@@ -138,7 +147,7 @@ class Surf : protected Pointers {
   typedef std::tr1::unordered_map<TwoPoint3d,int,TwoPoint3dHash> MyHash2Point;
   typedef std::tr1::unordered_map<TwoPoint3d,int,TwoPoint3dHash>::
     iterator My2PointIt;
-  typedef std::tr1::unordered_map<cellint,int> MyCellHash;
+  typedef FlatHash<cellint> MyCellHash;
 #endif
 
   MySurfHash *hash;           // hash for nlocal surf IDs
@@ -165,6 +174,7 @@ class Surf : protected Pointers {
 
   void setup_owned();
   void setup_bbox();
+  void setup_cache();
 
   void compute_line_normal(int);
   void compute_tri_normal(int);
@@ -205,10 +215,12 @@ class Surf : protected Pointers {
   void collate_vector(int, surfint *, double *, int, double *);
   void collate_vector_reduce(int, surfint *, double *, int, double *);
   void collate_vector_rendezvous(int, surfint *, double *, int, double *);
+  void collate_vector_scatter(int, surfint *, double *, int, double *);
 
   void collate_array(int, int, surfint *, double **, double **);
   void collate_array_reduce(int, int, surfint *, double **, double **);
   void collate_array_rendezvous(int, int, surfint *, double **, double **);
+  void collate_array_scatter(int, int, surfint *, double **, double **);
   void collate_vector_implicit(int, surfint *, double *, double *);
   void collate_array_implicit(int, int, surfint *, double **, double **);
 
@@ -228,6 +240,8 @@ class Surf : protected Pointers {
   int me,nprocs;
   int maxsc;                // max # of models in sc
   int maxsr;                // max # of models in sr
+  int maxcache;             // # of surfs cache memory is allocated for
+  void *cachemem;           // cache memory, lcache/tcache are aligned in it
   
   // collate vector rendezvous data
 
@@ -276,6 +290,7 @@ class Surf : protected Pointers {
   void point_tri_compare(double *, double *, double *, double *, double *,
                          double, int &, int &, int, int, int);
 
+  int collate_choose(int, int);
   void collate_vector_allreduce(int, int *, double *, int, double *);
   void collate_vector_irregular(int, int *, double *, int, double *);
   void collate_array_allreduce(int, int, int *, double **, double **);
@@ -334,4 +349,9 @@ E: Invalid surf_collide style
 
 Self-explanatory.
 
+E: Too many surfs to tally scatter - use global surftally rvous
+
+The dense vector or array of all surface element tallies is too long
+for an MPI_Reduce_scatter() operation.
+
 */
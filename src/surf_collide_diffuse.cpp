@@ -129,12 +129,19 @@ void SurfCollideDiffuse::init()
     if (!input->variable->equal_style(tvar))
       error->all(FLERR,"Surf_collide diffuse variable is invalid style");
   }
+
+  // counter-based RNG streams are keyed by a seed from the master RNG,
+  //   which is the same on all procs, and re-selected for each collision
+
+  if (update->rng_counter) random->counter(update->ranmaster->uniform());
+  else random->counter(-1.0);
 }
 
 /* ----------------------------------------------------------------------
    particle collision with surface with optional chemistry
    ip = particle with current x = collision pt, current v = incident v
    norm = surface normal unit vector
+   dtremain = remaining time in particle move, differs for each bounce
    isr = index of reaction model if >= 0, -1 for no chemistry
    ip = set to NULL if destroyed by chemsitry
    return jp = new particle if created by chemistry
@@ -143,10 +150,21 @@ void SurfCollideDiffuse::init()
 ------------------------------------------------------------------------- */
 
 Particle::OnePart *SurfCollideDiffuse::
-collide(Particle::OnePart *&ip, double *norm, double &, int isr, int &reaction)
+collide(Particle::OnePart *&ip, double *norm, double &dtremain, int isr, 
+        int &reaction)
 {
   nsingle++;
 
+  // counter-based RNG stream is keyed by timestep, particle ID, and dtremain
+  // so RNs do not depend on which proc or thread performs the collision
+  // dtremain is binned so round-off in moves split across procs is ignored
+
+  if (update->rng_counter) {
+    double tfrac = dtremain / update->dt;
+    random->stream(update->ntimestep,ip->id,
+                   static_cast<uint64_t> (tfrac*MAXSMALLINT));
+  }
+
   // if surface chemistry defined, attempt reaction
   // reaction > 0 if reaction took place
 
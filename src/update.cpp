@@ -39,6 +39,10 @@
 #include "memory.h"
 #include "error.h"
 
+#if defined(_OPENMP)
+#include "omp.h"
+#endif
+
 // DEBUG
 #include "fix_ablate.h"
 
@@ -49,7 +53,7 @@ enum{PERIODIC,OUTFLOW,REFLECT,SURFACE,AXISYM};  // same as Domain
 enum{OUTSIDE,INSIDE,ONSURF2OUT,ONSURF2IN};      // several files
 enum{PKEEP,PINSERT,PDONE,PDISCARD,PENTRY,PEXIT,PSURF};   // several files
 enum{NCHILD,NPARENT,NUNKNOWN,NPBCHILD,NPBPARENT,NPBUNKNOWN,NBOUND};  // Grid
-enum{TALLYAUTO,TALLYREDUCE,TALLYRVOUS};         // same as Surf
+enum{TALLYAUTO,TALLYREDUCE,TALLYRVOUS,TALLYSCATTER};  // same as Surf
 enum{PERAUTO,PERCELL,PERSURF};                  // several files
 
 #define MAXSTUCK 20
@@ -96,7 +100,13 @@ Update::Update(SPARTA *sparta) : Pointers(sparta)
 
   ranmaster = new RanMars(sparta);
 
+  nthreads = maxthreads = 0;
+  pipeflag = 0;
+  tfirst = tnmigrate = tndirty = NULL;
+
   reorder_period = 0;
+  sort_incremental = 0;
+  rng_counter = 0;
   global_mem_limit = 0;
   mem_limit_grid_flag = 0;
 
@@ -111,6 +121,9 @@ Update::~Update()
 
   delete [] unit_style;
   memory->destroy(mlist);
+  memory->destroy(tfirst);
+  memory->destroy(tnmigrate);
+  memory->destroy(tndirty);
   delete [] slist_compute;
   delete [] blist_compute;
   delete [] slist_active;
@@ -184,6 +197,25 @@ void Update::init()
 
   if (moveperturb) perturbflag = 1;
   else perturbflag = 0;
+
+  // # of OpenMP threads that split the particle loop in move()
+  // particles created by surface reactions are appended to the loop,
+  //   so it is only threaded if no surface reaction models are defined
+
+  nthreads = 1;
+#if defined(_OPENMP)
+  if (surf->nsr == 0) nthreads = omp_get_max_threads();
+#endif
+
+  if (nthreads > maxthreads) {
+    maxthreads = nthreads;
+    memory->destroy(tfirst);
+    memory->destroy(tnmigrate);
+    memory->destroy(tndirty);
+    memory->create(tfirst,maxthreads,"update:tfirst");
+    memory->create(tnmigrate,maxthreads,"update:tnmigrate");
+    memory->create(tndirty,maxthreads,"update:tndirty");
+  }
 }
 
 /* ---------------------------------------------------------------------- */
@@ -212,7 +244,14 @@ void Update::setup()
   dynamic = 0;
   dynamic_setup();
 
+  particle->incremental = 0;
+
   modify->setup();
+
+  // insure compact copy of grid cells used by move() is current
+
+  if (grid->nhcell != grid->nlocal + grid->nghost) grid->hot_cells();
+
   output->setup(1);
 }
 
@@ -228,6 +267,8 @@ void Update::run(int nsteps)
   int cellweightflag = 0;
   if (grid->cellweightflag) cellweightflag = 1;
 
+  int reorderflag;
+
   // loop over timesteps
 
   for (int i = 0; i < nsteps; i++) {
@@ -258,14 +299,24 @@ void Update::run(int nsteps)
 
     // communicate particles
 
-    comm->migrate_particles(nmigrate,mlist);
+    if (!pipeflag) comm->migrate_particles(nmigrate,mlist);
     if (cellweightflag) particle->post_weight();
     timer->stamp(TIME_COMM);
 
-    if (collide) {
-      particle->sort();
+    // sort particles by grid cell
+    // if requested, periodically reorder them so each cell is contiguous
+
+    reorderflag = 0;
+    if (reorder_period && ntimestep % reorder_period == 0) reorderflag = 1;
+
+    if (collide || reorderflag) {
+      if (sort_incremental) particle->sort_incremental();
+      else particle->sort();
+      if (reorderflag) particle->reorder();
       timer->stamp(TIME_SORT);
+    }
 
+    if (collide) {
       collide->collisions();
       timer->stamp(TIME_COLLIDE);
     }
@@ -383,10 +434,16 @@ void Update::run(int nsteps)
 template < int DIM, int SURF > void Update::move()
 {
   bool hitflag;
-  int m,icell,icell_original,nmask,outface,bflag,nflag,pflag,itmp;
+  int m,icell,icell_original,icell_start,nmask,outface,bflag,nflag,pflag,itmp;
   int side,minside,minsurf,nsurf,cflag,isurf,exclude,stuck_iterate;
-  int pstart,pstop,entryexit,any_entryexit,reaction;
+  int pstart = 0,pstop = 0;
+  int entryexit,any_entryexit,reaction,ndirty;
+  int ntouch,ncomm,nboundary,nexit,nscheck,nscollide,nstuck_one;
+  int k,nlist,ntest,ibin,bflo[3],bfhi[3];
+  int *slist;
+  unsigned char *sbox;
   surfint *csurfs;
+  Grid::SurfBin *sb;
   cellint *neigh;
   double dtremain,frac,newfrac,param,minparam,rnew,dtsurf,tc,tmp;
   double xnew[3],xhold[3],xc[3],vc[3],minxc[3],minvc[3];
@@ -397,11 +454,6 @@ template < int DIM, int SURF > void Update::move()
   Particle::OnePart *particles;
   Particle::OnePart *ipart,*jpart;
 
-  // for 2d and axisymmetry only
-  // xnew,xc passed to geometry routines which use or set z component
-
-  if (DIM < 3) xnew[2] = xc[2] = 0.0;
-
   // extend migration list if necessary
 
   int nlocal = particle->nlocal;
@@ -413,6 +465,11 @@ template < int DIM, int SURF > void Update::move()
     memory->create(mlist,maxmigrate,"particle:mlist");
   }
 
+  // if particle cell lists are patched incrementally,
+  //   record particles whose icell changes
+
+  int dirtyflag = particle->incremental;
+
   // counters
 
   niterate = 0;
@@ -424,29 +481,100 @@ template < int DIM, int SURF > void Update::move()
   // move/migrate iterations
 
   Grid::ChildCell *cells = grid->cells;
+  Grid::HotCell *hcells = grid->hcells;
+  int nsbincell = 0;
+  if (DIM > 1) nsbincell = grid->nsbincell;
   Surf::Tri *tris = surf->tris;
   Surf::Line *lines = surf->lines;
+  Geometry::TriCache *tcache = NULL;
+  Geometry::LineCache *lcache = NULL;
+  if (DIM > 1 && surf->ncache) {
+    tcache = surf->tcache;
+    lcache = surf->lcache;
+  }
   double dt = update->dt;
   int notfirst = 0;
+  int nchunk = 1;
+  int ichunk = 0;
+  int cstart,cstop,mfirst;
+  pipeflag = 0;
 
   while (1) {
 
     // loop over particles
     // first iteration = all my particles
     // subsequent iterations = received particles
+    // if pipelined, each iteration moves particles in nchunk chunks,
+    //   one chunk per pass thru this loop, migrants of each chunk are
+    //   sent while later chunks are moved, only if no surface reactions
+    //   since they append particles to the end of the particle list
+
+    if (ichunk == 0) {
+      niterate++;
+      nmigrate = 0;
+      entryexit = 0;
+
+      if (notfirst == 0) {
+        notfirst = 1;
+        pstart = 0;
+        pstop = nlocal;
+      }
+
+      if (surf->nsr == 0 && comm->migrate_pipe_start()) {
+        nchunk = comm->npipe;
+        pipeflag = 1;
+      }
+      cstart = pstart;
+    }
 
-    niterate++;
     particles = particle->particles;
-    nmigrate = 0;
-    entryexit = 0;
+    cstop = pstart + (bigint) (pstop-pstart)*(ichunk+1)/nchunk;
+    mfirst = nmigrate;
+
+    // if nthreads > 1, each thread moves a contiguous chunk of particles
+    // each thread stores indices in its own section of mlist and dirty list,
+    //   sections are compacted in thread order after the loop,
+    //   so that mlist stays in ascending order for compress_migrate()
+    // surf and boundary collisions and their tallies are done by
+    //   one thread at a time, since SurfCollide and Compute classes
+    //   store state, e.g. RNGs and tally arrays
+
+    ndirty = particle->ndirty;
+    if (dirtyflag) particle->grow_dirty(ndirty + cstop-cstart);
+
+    ntouch = ncomm = nboundary = nexit = 0;
+    nscheck = nscollide = nstuck_one = 0;
+
+#if defined(_OPENMP)
+#pragma omp parallel num_threads(nthreads) \
+  private(hitflag,m,icell,icell_original,icell_start,nmask,outface,bflag, \
+          nflag,pflag,itmp,side,minside,minsurf,nsurf,cflag,isurf,exclude, \
+          stuck_iterate,reaction,csurfs,neigh,dtremain,frac,newfrac,param, \
+          minparam,rnew,dtsurf,tc,tmp,xnew,xhold,xc,vc,minxc,minvc, \
+          x,v,lo,hi,tri,line,iorig,ipart,jpart, \
+          k,nlist,ntest,ibin,bflo,bfhi,slist,sbox,sb) \
+  reduction(+:ntouch,ncomm,nboundary,nexit,nscheck,nscollide,nstuck_one) \
+  reduction(max:entryexit)
+#endif
+    {
+    int tid = 0;
+#if defined(_OPENMP)
+    tid = omp_get_thread_num();
+#endif
+    int ifirst = cstart + (bigint) (cstop-cstart)*tid/nthreads;
+    int ilast = cstart + (bigint) (cstop-cstart)*(tid+1)/nthreads;
+    int *tmlist = &mlist[mfirst+ifirst-cstart];
+    int *tdirty = NULL;
+    if (dirtyflag) tdirty = &particle->dirty[ndirty+ifirst-cstart];
+    int nm = 0;
+    int nd = 0;
 
-    if (notfirst == 0) {
-      notfirst = 1;
-      pstart = 0;
-      pstop = nlocal;
-    }
+    // for 2d and axisymmetry only
+    // xnew,xc passed to geometry routines which use or set z component
+
+    if (DIM < 3) xnew[2] = xc[2] = 0.0;
 
-    for (int i = pstart; i < pstop; i++) {
+    for (int i = ifirst; i < ilast; i++) {
       pflag = particles[i].flag;
 
       // received from another proc and move is done
@@ -459,6 +587,7 @@ template < int DIM, int SURF > void Update::move()
         if (niterate > 1) continue;
       }
 
+      icell_start = particles[i].icell;
       x = particles[i].x;
       v = particles[i].v;
       exclude = -1;
@@ -482,7 +611,7 @@ template < int DIM, int SURF > void Update::move()
         if (perturbflag) (this->*moveperturb)(dtremain,xnew,v);
       } else if (pflag == PENTRY) {
         icell = particles[i].icell;
-        if (cells[icell].nsplit > 1) {
+        if (hcells[icell].nsplit > 1) {
           if (DIM == 3 && SURF) icell = split3d(icell,x);
           if (DIM < 3 && SURF) icell = split2d(icell,x);
           particles[i].icell = icell;
@@ -506,12 +635,12 @@ template < int DIM, int SURF > void Update::move()
 
       particles[i].flag = PKEEP;
       icell = particles[i].icell;
-      lo = cells[icell].lo;
-      hi = cells[icell].hi;
-      neigh = cells[icell].neigh;
-      nmask = cells[icell].nmask;
+      lo = hcells[icell].lo;
+      hi = hcells[icell].hi;
+      neigh = hcells[icell].neigh;
+      nmask = hcells[icell].nmask;
       stuck_iterate = 0;
-      ntouch_one++;
+      ntouch++;
 
       // advect one particle from cell to cell and thru surf collides til done
 
@@ -668,7 +797,7 @@ template < int DIM, int SURF > void Update::move()
 
         if (SURF) {
 
-          nsurf = cells[icell].nsurf;
+          nsurf = hcells[icell].nsurf;
           if (nsurf) {
 
             // particle crosses cell face, reset xnew exactly on face of cell
@@ -707,25 +836,70 @@ template < int DIM, int SURF > void Update::move()
             // if collision occurs, perform collision with surface model
             // reset x,v,xnew,dtremain and continue single particle trajectory
 
+            // if surfs in cell are binned, only test surfs whose bins
+            //   overlap the bins of the bbox of the particle path,
+            //   path is within cell so culled surfs cannot be hit
+            // if path is in a single bin, loop over its list of surfs
+            // else loop over all surfs and skip non-overlapping ones
+            // either way surfs are tested in same order as csurfs
+
             cflag = 0;
             minparam = 2.0;
             csurfs = cells[icell].csurfs;
-            for (m = 0; m < nsurf; m++) {
+            nlist = nsurf;
+            ntest = 0;
+            slist = NULL;
+            sbox = NULL;
+
+            if (icell < nsbincell && grid->sbincell[icell] >= 0) {
+              sb = &grid->sbins[grid->sbincell[icell]];
+              for (k = 0; k < 3; k++) {
+                bflo[k] = grid->sbin_coord(sb,k,MIN(x[k],xnew[k]));
+                bfhi[k] = grid->sbin_coord(sb,k,MAX(x[k],xnew[k]));
+              }
+              if (bflo[0] == bfhi[0] && bflo[1] == bfhi[1] &&
+                  bflo[2] == bfhi[2]) {
+                ibin = sb->offset +
+                  (bflo[2]*sb->nbin[1] + bflo[1])*sb->nbin[0] + bflo[0];
+                slist = &grid->sbinlist[grid->sbinstart[ibin]];
+                nlist = grid->sbinstart[ibin+1] - grid->sbinstart[ibin];
+              } else sbox = &grid->sbinbox[sb->boxoffset];
+            }
+
+            for (k = 0; k < nlist; k++) {
+              if (slist) m = slist[k];
+              else {
+                m = k;
+                if (sbox && 
+                    (sbox[6*m] > bfhi[0] || sbox[6*m+1] < bflo[0] ||
+                     sbox[6*m+2] > bfhi[1] || sbox[6*m+3] < bflo[1] ||
+                     sbox[6*m+4] > bfhi[2] || sbox[6*m+5] < bflo[2]))
+                  continue;
+              }
               isurf = csurfs[m];
               if (DIM > 1) {
                 if (isurf == exclude) continue;
               }
+              ntest++;
               if (DIM == 3) {
                 tri = &tris[isurf];
-                hitflag = Geometry::
-                  line_tri_intersect(x,xnew,tri->p1,tri->p2,tri->p3,
-                                     tri->norm,xc,param,side);
+                if (tcache)
+                  hitflag = Geometry::
+                    line_tri_intersect(x,xnew,tcache[isurf],xc,param,side);
+                else
+                  hitflag = Geometry::
+                    line_tri_intersect(x,xnew,tri->p1,tri->p2,tri->p3,
+                                       tri->norm,xc,param,side);
               }
               if (DIM == 2) {
                 line = &lines[isurf];
-                hitflag = Geometry::
-                  line_line_intersect(x,xnew,line->p1,line->p2,
-                                      line->norm,xc,param,side);
+                if (lcache)
+                  hitflag = Geometry::
+                    line_line_intersect(x,xnew,lcache[isurf],xc,param,side);
+                else
+                  hitflag = Geometry::
+                    line_line_intersect(x,xnew,line->p1,line->p2,
+                                        line->norm,xc,param,side);
               }
               if (DIM == 1) {
                 line = &lines[isurf];
@@ -813,7 +987,8 @@ template < int DIM, int SURF > void Update::move()
 
             } // END of for loop over surfs
 
-            nscheck_one += nsurf;
+            if (slist || sbox) nscheck += ntest;
+            else nscheck += nsurf;
             
             if (cflag) {
               if (DIM == 3) tri = &tris[minsurf];
@@ -834,13 +1009,17 @@ template < int DIM, int SURF > void Update::move()
               // surface chemistry may destroy particle or create new one
               // must update particle's icell to current icell so that
               //   if jpart is created, it will be added to correct cell
-              // if jpart, add new particle to this iteration via pstop++
+              // if jpart, add new particle to this iteration via ilast++
               // tally surface statistics if requested using iorig
 
               ipart = &particles[i];
               ipart->icell = icell;
               dtremain *= 1.0 - minparam*frac;
 
+#if defined(_OPENMP)
+#pragma omp critical (update_move_collide)
+#endif
+              {
               if (nsurf_tally) 
                 memcpy(&iorig,&particles[i],sizeof(Particle::OnePart));
 
@@ -858,13 +1037,14 @@ template < int DIM, int SURF > void Update::move()
                 jpart->flag = PSURF + 1 + minsurf;
                 jpart->dtremain = dtremain;
                 jpart->weight = particles[i].weight;
-                pstop++;
+                ilast++;
               }
 
               if (nsurf_tally)
                 for (m = 0; m < nsurf_tally; m++)
                   slist_active[m]->surf_tally(minsurf,icell,reaction,
                                               &iorig,ipart,jpart);
+              }
               
               // nstuck = consective iterations particle is immobile
 
@@ -878,7 +1058,7 @@ template < int DIM, int SURF > void Update::move()
               if (DIM != 2) xnew[2] = x[2] + dtremain*v[2];
 
               exclude = minsurf;
-              nscollide_one++;
+              nscollide++;
               
 #ifdef MOVE_DEBUG
               if (DIM == 3) {
@@ -920,7 +1100,7 @@ template < int DIM, int SURF > void Update::move()
               else if (stuck_iterate < MAXSTUCK) continue;
               else {
                 particles[i].flag = PDISCARD;
-                nstuck++;
+                nstuck_one++;
               }
 
             } // END of cflag if section that performed collision
@@ -951,7 +1131,7 @@ template < int DIM, int SURF > void Update::move()
           x[0] = xnew[0];
           x[1] = xnew[1];
           if (DIM == 3) x[2] = xnew[2];
-          if (cells[icell].proc != me) particles[i].flag = PDONE;
+          if (hcells[icell].proc != me) particles[i].flag = PDONE;
           break;
         }
           
@@ -996,22 +1176,22 @@ template < int DIM, int SURF > void Update::move()
         if (nflag == NCHILD) {
           icell = neigh[outface];
           if (DIM == 3 && SURF) {
-            if (cells[icell].nsplit > 1 && cells[icell].nsurf >= 0)
+            if (hcells[icell].nsplit > 1 && hcells[icell].nsurf >= 0)
               icell = split3d(icell,x);
           }
           if (DIM < 3 && SURF) {
-            if (cells[icell].nsplit > 1 && cells[icell].nsurf >= 0)
+            if (hcells[icell].nsplit > 1 && hcells[icell].nsurf >= 0)
               icell = split2d(icell,x);
           }
         } else if (nflag == NPARENT) {
           icell = grid->id_find_child(neigh[outface],x);
           if (icell >= 0) {
             if (DIM == 3 && SURF) {
-              if (cells[icell].nsplit > 1 && cells[icell].nsurf >= 0)
+              if (hcells[icell].nsplit > 1 && hcells[icell].nsurf >= 0)
                 icell = split3d(icell,x);
             }
             if (DIM < 3 && SURF) {
-              if (cells[icell].nsplit > 1 && cells[icell].nsurf >= 0)
+              if (hcells[icell].nsplit > 1 && hcells[icell].nsurf >= 0)
                 icell = split2d(icell,x);
             }
           }
@@ -1023,7 +1203,7 @@ template < int DIM, int SURF > void Update::move()
         //   may also update dtremain (piston BC)
         // for axisymmetric, must recalculate xnew since v may have changed
         // surface chemistry may destroy particle or create new one
-        // if jpart, add new particle to this iteration via pstop++
+        // if jpart, add new particle to this iteration via ilast++
         // OUTFLOW: exit with particle flag = PDISCARD
         // PERIODIC: new cell via same logic as above for child/parent/unknown
         // other = reflected particle stays in same grid cell
@@ -1031,6 +1211,10 @@ template < int DIM, int SURF > void Update::move()
         else {
           ipart = &particles[i];
 
+#if defined(_OPENMP)
+#pragma omp critical (update_move_collide)
+#endif
+          {
           if (nboundary_tally) 
             memcpy(&iorig,&particles[i],sizeof(Particle::OnePart));
 
@@ -1047,6 +1231,7 @@ template < int DIM, int SURF > void Update::move()
             for (m = 0; m < nboundary_tally; m++)
               blist_active[m]->
                 boundary_tally(outface,bflag,reaction,&iorig,ipart,jpart);
+          }
 
           if (DIM == 1) {
             xnew[0] = x[0] + dtremain*v[0];
@@ -1056,29 +1241,29 @@ template < int DIM, int SURF > void Update::move()
 
           if (bflag == OUTFLOW) {
             particles[i].flag = PDISCARD;
-            nexit_one++;
+            nexit++;
             break;
 
           } else if (bflag == PERIODIC) {
             if (nflag == NPBCHILD) {
               icell = neigh[outface];
               if (DIM == 3 && SURF) {
-                if (cells[icell].nsplit > 1 && cells[icell].nsurf >= 0)
+                if (hcells[icell].nsplit > 1 && hcells[icell].nsurf >= 0)
                   icell = split3d(icell,x);
               }
               if (DIM < 3 && SURF) {
-                if (cells[icell].nsplit > 1 && cells[icell].nsurf >= 0)
+                if (hcells[icell].nsplit > 1 && hcells[icell].nsurf >= 0)
                   icell = split2d(icell,x);
               }
             } else if (nflag == NPBPARENT) {
               icell = grid->id_find_child(neigh[outface],x);
               if (icell >= 0) {
                 if (DIM == 3 && SURF) {
-                  if (cells[icell].nsplit > 1 && cells[icell].nsurf >= 0)
+                  if (hcells[icell].nsplit > 1 && hcells[icell].nsurf >= 0)
                     icell = split3d(icell,x);
                 }
                 if (DIM < 3 && SURF) {
-                  if (cells[icell].nsplit > 1 && cells[icell].nsurf >= 0)
+                  if (hcells[icell].nsplit > 1 && hcells[icell].nsurf >= 0)
                     icell = split2d(icell,x);
                 }
               } else domain->uncollide(outface,x);
@@ -1095,14 +1280,14 @@ template < int DIM, int SURF > void Update::move()
               jpart->flag = PSURF;
               jpart->dtremain = dtremain;
               jpart->weight = particles[i].weight;
-              pstop++;
+              ilast++;
             }
-            nboundary_one++;
-            ntouch_one--;    // decrement here since will increment below
+            nboundary++;
+            ntouch--;    // decrement here since will increment below
 
           } else {
-            nboundary_one++;
-            ntouch_one--;    // decrement here since will increment below
+            nboundary++;
+            ntouch--;    // decrement here since will increment below
           }
         }
 
@@ -1121,7 +1306,7 @@ template < int DIM, int SURF > void Update::move()
         // if nsurf < 0, new cell is EMPTY ghost
         // exit with particle flag = PENTRY, so receiver can continue move
         
-        if (cells[icell].nsurf < 0) {
+        if (hcells[icell].nsurf < 0) {
           particles[i].flag = PENTRY;
           particles[i].dtremain = dtremain;
           entryexit = 1;
@@ -1130,11 +1315,11 @@ template < int DIM, int SURF > void Update::move()
 
         // move particle into new grid cell for next stage of move
 
-        lo = cells[icell].lo;
-        hi = cells[icell].hi;
-        neigh = cells[icell].neigh;
-        nmask = cells[icell].nmask;
-        ntouch_one++;
+        lo = hcells[icell].lo;
+        hi = hcells[icell].hi;
+        neigh = hcells[icell].neigh;
+        nmask = hcells[icell].nmask;
+        ntouch++;
       }
 
       // END of while loop over advection of single particle
@@ -1154,11 +1339,13 @@ template < int DIM, int SURF > void Update::move()
       // if discarding, migration will delete particle
     
       particles[i].icell = icell;
+
+      if (dirtyflag && icell != icell_start && i < cstop) tdirty[nd++] = i;
       
       if (particles[i].flag != PKEEP) {
-        mlist[nmigrate++] = i;
+        tmlist[nm++] = i;
         if (particles[i].flag != PDISCARD) {
-          if (cells[icell].proc == me) {
+          if (hcells[icell].proc == me) {
             char str[128];
             sprintf(str,
                     "Particle %d on proc %d being sent to self "
@@ -1166,12 +1353,77 @@ template < int DIM, int SURF > void Update::move()
                     i,me,update->ntimestep);
             error->one(FLERR,str);
           }
-          ncomm_one++;
+          ncomm++;
         }
       }
     }
 
     // END of pstart/pstop loop advecting all particles
+
+    tfirst[tid] = ifirst-cstart;
+    tnmigrate[tid] = nm;
+    tndirty[tid] = nd;
+    }
+
+    // END of parallel region
+
+    nmigrate = mfirst + tnmigrate[0];
+    for (m = 1; m < nthreads; m++) {
+      memmove(&mlist[nmigrate],&mlist[mfirst+tfirst[m]],
+              tnmigrate[m]*sizeof(int));
+      nmigrate += tnmigrate[m];
+    }
+
+    if (dirtyflag) {
+      int *dirty = particle->dirty;
+      int n = ndirty + tndirty[0];
+      for (m = 1; m < nthreads; m++) {
+        memmove(&dirty[n],&dirty[ndirty+tfirst[m]],tndirty[m]*sizeof(int));
+        n += tndirty[m];
+      }
+      particle->ndirty = n;
+    }
+
+    ntouch_one += ntouch;
+    ncomm_one += ncomm;
+    nboundary_one += nboundary;
+    nexit_one += nexit;
+    nscheck_one += nscheck;
+    nscollide_one += nscollide;
+    nstuck += nstuck_one;
+
+    // if pipelined, send migrants of this chunk and move the next one
+    // after last chunk, complete migration of all chunks
+    // if gridcut >= 0.0, iterate again if any particle flag = PENTRY/PEXIT
+    // else move is done and run() performs no further particle comm
+
+    if (pipeflag) {
+      timer->stamp(TIME_MOVE);
+      comm->migrate_pipe_chunk(nmigrate-mfirst,&mlist[mfirst]);
+      timer->stamp(TIME_COMM);
+
+      if (++ichunk < nchunk) {
+        cstart = cstop;
+        continue;
+      }
+      ichunk = 0;
+
+      pstart = comm->migrate_pipe_finish(nmigrate,mlist);
+      timer->stamp(TIME_COMM);
+      nmigrate = 0;
+      pstop = particle->nlocal;
+      if (pstop-pstart > maxmigrate) {
+        maxmigrate = pstop-pstart;
+        memory->destroy(mlist);
+        memory->create(mlist,maxmigrate,"particle:mlist");
+      }
+
+      if (grid->cutoff < 0.0) break;
+      MPI_Allreduce(&entryexit,&any_entryexit,1,MPI_INT,MPI_MAX,world);
+      timer->stamp();
+      if (any_entryexit) continue;
+      break;
+    }
     
     // if gridcut >= 0.0, check if another iteration of move is required
     // only the case if some particle flag = PENTRY/PEXIT
@@ -1527,6 +1779,33 @@ void Update::global(int narg, char **arg)
       // reallocate paged data structs for variable-length surf info
       grid->allocate_surf_arrays();
       iarg += 2;
+    } else if (strcmp(arg[iarg],"surfbin") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal global command");
+      grid->surfbin = atoi(arg[iarg+1]);
+      if (grid->surfbin < 0) error->all(FLERR,"Illegal global command");
+      if (grid->exist_ghost) {
+        if (grid->surfbin) grid->surf_bins();
+        else grid->nsbincell = 0;
+      }
+      iarg += 2;
+    } else if (strcmp(arg[iarg],"parent/compress") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal global command");
+      if (grid->exist)
+        error->all(FLERR,
+                   "Cannot set global parent/compress when grid is defined");
+      if (strcmp(arg[iarg+1],"yes") == 0) grid->pcompress = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) grid->pcompress = 0;
+      else error->all(FLERR,"Illegal global command");
+      if (grid->pcompress && sparta->kokkos)
+        error->all(FLERR,"Cannot use global parent/compress with Kokkos");
+      iarg += 2;
+    } else if (strcmp(arg[iarg],"surfcache") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal global command");
+      if (strcmp(arg[iarg+1],"yes") == 0) surf->cacheflag = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) surf->cacheflag = 0;
+      else error->all(FLERR,"Illegal global command");
+      if (grid->exist_ghost) surf->setup_cache();
+      iarg += 2;
     } else if (strcmp(arg[iarg],"cellmax") == 0) {
       if (iarg+2 > narg) error->all(FLERR,"Illegal global command");
       if (surf->exist) 
@@ -1587,11 +1866,24 @@ void Update::global(int narg, char **arg)
       else if (strcmp(arg[iarg+1],"all") == 0) comm->commpartstyle = 0;
       else error->all(FLERR,"Illegal global command");
       iarg += 2;
+    } else if (strcmp(arg[iarg],"comm/shared") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal global command");
+      if (strcmp(arg[iarg+1],"yes") == 0) comm->sharedflag = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) comm->sharedflag = 0;
+      else error->all(FLERR,"Illegal global command");
+      iarg += 2;
+    } else if (strcmp(arg[iarg],"comm/pipe") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal global command");
+      comm->npipe = input->inumeric(FLERR,arg[iarg+1]);
+      if (comm->npipe < 1) error->all(FLERR,"Illegal global command");
+      iarg += 2;
     } else if (strcmp(arg[iarg],"surftally") == 0) {
       if (iarg+2 > narg) error->all(FLERR,"Illegal global command");
       if (strcmp(arg[iarg+1],"auto") == 0) surf->tally_comm = TALLYAUTO;
       else if (strcmp(arg[iarg+1],"reduce") == 0) surf->tally_comm = TALLYREDUCE;
       else if (strcmp(arg[iarg+1],"rvous") == 0) surf->tally_comm = TALLYRVOUS;
+      else if (strcmp(arg[iarg+1],"scatter") == 0)
+        surf->tally_comm = TALLYSCATTER;
       else error->all(FLERR,"Illegal global command");
       iarg += 2;
 
@@ -1602,6 +1894,18 @@ void Update::global(int narg, char **arg)
       if (strcmp(arg[iarg+1],"cell") == 0) grid->weight(1,&arg[iarg+2]);
       else error->all(FLERR,"Illegal weight command");
       iarg += 3;
+    } else if (strcmp(arg[iarg],"particle/sort") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal global command");
+      if (strcmp(arg[iarg+1],"full") == 0) sort_incremental = 0;
+      else if (strcmp(arg[iarg+1],"incremental") == 0) sort_incremental = 1;
+      else error->all(FLERR,"Illegal global command");
+      iarg += 2;
+    } else if (strcmp(arg[iarg],"rng") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal global command");
+      if (strcmp(arg[iarg+1],"park") == 0) rng_counter = 0;
+      else if (strcmp(arg[iarg+1],"philox") == 0) rng_counter = 1;
+      else error->all(FLERR,"Illegal global command");
+      iarg += 2;
     } else if (strcmp(arg[iarg],"particle/reorder") == 0) {
       reorder_period = input->inumeric(FLERR,arg[iarg+1]);
       if (reorder_period < 0) error->all(FLERR,"Illegal global command");
@@ -65,6 +65,9 @@ class Update : protected Pointers {
   int nstuck;                // # of particles stuck on surfs and deleted
 
   int reorder_period;        // # of timesteps between particle reordering
+  int sort_incremental;      // 1 if particle sort patches cell lists
+                             // 0 if it rebuilds them every step
+  int rng_counter;           // 1 if stochastic kernels use counter-based RNG
   int global_mem_limit;      // max # of bytes in arrays for rebalance and reordering
   int mem_limit_grid_flag;   // 1 if using size of grid as memory limit
   void set_mem_limit_grid();
@@ -91,6 +94,13 @@ class Update : protected Pointers {
  protected:
   int me,nprocs;
   int maxmigrate;            // max # of particles in mlist
+
+  int nthreads;              // # of OpenMP threads used by move()
+  int maxthreads;            // max # of threads per-thread vectors can hold
+  int *tfirst;               // offset of each thread's section of mlist
+  int *tnmigrate;            // # of mlist indices stored by each thread
+  int *tndirty;              // # of dirty indices stored by each thread
+  int pipeflag;              // 1 if move() performed particle migration
   class RanPark *random;     // RNG for particle timestep moves
 
   int collide_react;         // 1 if any SurfCollide or React classes defined
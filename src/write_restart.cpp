@@ -33,7 +33,7 @@ using namespace SPARTA_NS;
 #define MAGIC_STRING "SpartA RestartT"
 #define ENDIAN 0x0001
 #define ENDIANSWAP 0x1000
-#define VERSION_NUMERIC 0
+#define VERSION_NUMERIC 1
 
 enum{VERSION,SMALLINT,CELLINT,BIGINT,
      UNITS,NTIMESTEP,NPROCS,